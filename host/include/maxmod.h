@@ -0,0 +1,13 @@
+// Host stand-in for maxmod, every call is a no-op
+#ifndef MAXMOD_H
+#define MAXMOD_H
+
+#include "mm_types.h"
+
+void mmInitDefault(mm_addr soundbank, mm_word number_of_channels);
+void mmStart(mm_word module_ID, mm_pmode mode);
+void mmFrame(void);
+void mmVBlank(void);
+mm_sfxhand mmEffectEx(mm_sound_effect *sound);
+
+#endif
@@ -0,0 +1,24 @@
+// Host stand-in for maxmod's mm_types.h
+#ifndef MM_TYPES_H
+#define MM_TYPES_H
+
+#include <stdint.h>
+
+typedef uint32_t mm_word;
+typedef uint16_t mm_hword;
+typedef uint8_t  mm_byte;
+typedef uint16_t mm_sfxhand;
+typedef void*    mm_addr;
+
+typedef struct t_mmsoundeffect
+{
+    union { mm_word id; mm_addr sample; };
+    mm_hword rate;
+    mm_sfxhand handle;
+    mm_byte volume;
+    mm_byte panning;
+} mm_sound_effect;
+
+typedef enum { MM_PLAY_LOOP, MM_PLAY_ONCE } mm_pmode;
+
+#endif
@@ -0,0 +1,311 @@
+/* Host stand-in for libtonc, used to build the game logic natively (see host/Makefile).
+ *
+ * Only the parts of libtonc the game uses are declared here.
+ * The memory map is backed by plain arrays and the registers live at their
+ * real offsets inside the IO array, so code that pokes them still works.
+ * Text, interrupts and BIOS calls do nothing.
+ */
+#ifndef TONC_MAIN_H
+#define TONC_MAIN_H
+
+#include <string.h>
+#include <stdio.h>
+#include "tonc_types.h"
+
+// ---- Memory map, backed by host arrays ------------------------------------
+extern u8 shim_io[0x400];
+extern u8 shim_pal[0x400];
+extern u8 shim_vram[0x18000];
+extern u8 shim_oam[0x400];
+extern u8 shim_sram[0x10000];
+
+#define MEM_IO      ((uintptr_t)shim_io)
+#define MEM_PAL     ((uintptr_t)shim_pal)
+#define MEM_VRAM    ((uintptr_t)shim_vram)
+#define MEM_OAM     ((uintptr_t)shim_oam)
+#define MEM_SRAM    ((uintptr_t)shim_sram)
+#define REG_BASE    MEM_IO
+
+#define pal_bg_mem      ((COLOR*)MEM_PAL)
+#define pal_obj_mem     ((COLOR*)(MEM_PAL + 0x200))
+#define pal_bg_bank     ((PALBANK*)MEM_PAL)
+#define pal_obj_bank    ((PALBANK*)(MEM_PAL + 0x200))
+#define tile_mem        ((CHARBLOCK*)MEM_VRAM)
+#define tile8_mem       ((CHARBLOCK8*)MEM_VRAM)
+#define se_mem          ((SCREENBLOCK*)MEM_VRAM)
+#define se_mat          ((SCREENMAT*)MEM_VRAM)
+#define oam_mem         ((OBJ_ATTR*)MEM_OAM)
+#define obj_aff_mem     ((OBJ_AFFINE*)MEM_OAM)
+
+#define REG_DISPCNT     *(vu32*)(REG_BASE + 0x0000)
+#define REG_DISPSTAT    *(vu16*)(REG_BASE + 0x0004)
+#define REG_VCOUNT      *(vu16*)(REG_BASE + 0x0006)
+#define REG_BGCNT       ((vu16*)(REG_BASE + 0x0008))
+#define REG_BG0CNT      *(vu16*)(REG_BASE + 0x0008)
+#define REG_BG1CNT      *(vu16*)(REG_BASE + 0x000A)
+#define REG_BG2CNT      *(vu16*)(REG_BASE + 0x000C)
+#define REG_BG3CNT      *(vu16*)(REG_BASE + 0x000E)
+#define REG_BG_AFFINE   ((BG_AFFINE*)(REG_BASE + 0x0000))
+#define REG_BG2PA       *(vs16*)(REG_BASE + 0x0020)
+#define REG_WIN0H       *(vu16*)(REG_BASE + 0x0040)
+#define REG_WIN1H       *(vu16*)(REG_BASE + 0x0042)
+#define REG_WIN0V       *(vu16*)(REG_BASE + 0x0044)
+#define REG_WIN1V       *(vu16*)(REG_BASE + 0x0046)
+#define REG_WININ       *(vu16*)(REG_BASE + 0x0048)
+#define REG_WINOUT      *(vu16*)(REG_BASE + 0x004A)
+#define REG_WIN0CNT     *(vu8*)(REG_BASE + 0x0048)
+#define REG_WIN1CNT     *(vu8*)(REG_BASE + 0x0049)
+#define REG_WINOUTCNT   *(vu8*)(REG_BASE + 0x004A)
+#define REG_BLDCNT      *(vu16*)(REG_BASE + 0x0050)
+#define REG_BLDALPHA    *(vu16*)(REG_BASE + 0x0052)
+#define REG_DMA0SAD     *(vu32*)(REG_BASE + 0x00B0)
+#define REG_DMA0DAD     *(vu32*)(REG_BASE + 0x00B4)
+#define REG_DMA0CNT     *(vu32*)(REG_BASE + 0x00B8)
+#define REG_DMA3SAD     *(vu32*)(REG_BASE + 0x00D4)
+#define REG_DMA3DAD     *(vu32*)(REG_BASE + 0x00D8)
+#define REG_DMA3CNT     *(vu32*)(REG_BASE + 0x00DC)
+#define REG_TM0D        *(vu16*)(REG_BASE + 0x0100)
+#define REG_TM0CNT      *(vu16*)(REG_BASE + 0x0102)
+#define REG_TM1D        *(vu16*)(REG_BASE + 0x0104)
+#define REG_TM1CNT      *(vu16*)(REG_BASE + 0x0106)
+#define REG_TM2D        *(vu16*)(REG_BASE + 0x0108)
+#define REG_TM2CNT      *(vu16*)(REG_BASE + 0x010A)
+#define REG_TM3D        *(vu16*)(REG_BASE + 0x010C)
+#define REG_TM3CNT      *(vu16*)(REG_BASE + 0x010E)
+#define REG_KEYINPUT    *(vu16*)(REG_BASE + 0x0130)
+#define REG_IE          *(vu16*)(REG_BASE + 0x0200)
+#define REG_IF          *(vu16*)(REG_BASE + 0x0202)
+#define REG_WAITCNT     *(vu16*)(REG_BASE + 0x0204)
+#define REG_IME         *(vu16*)(REG_BASE + 0x0208)
+
+// ---- Register bit definitions ----------------------------------------------
+#define DCNT_MODE0      0x0000
+#define DCNT_MODE1      0x0001
+#define DCNT_OBJ_1D     0x0040
+#define DCNT_BG0        0x0100
+#define DCNT_BG1        0x0200
+#define DCNT_BG2        0x0400
+#define DCNT_BG3        0x0800
+#define DCNT_OBJ        0x1000
+#define DCNT_WIN0       0x2000
+#define DCNT_WIN1       0x4000
+
+#define BG_MOSAIC       0x0040
+#define BG_4BPP         0
+#define BG_8BPP         0x0080
+#define BG_WRAP         0x2000
+#define BG_AFF_16x16    0
+#define BG_AFF_32x32    0x4000
+#define BG_PRIO(n)      ((n) & 3)
+#define BG_CBB(n)       ((n) << 2)
+#define BG_SBB(n)       ((n) << 8)
+#define BG_CBB_MASK     0x000C
+#define BG_SBB_MASK     0x1F00
+
+#define WIN_BG0         0x0001
+#define WIN_BG1         0x0002
+#define WIN_BG2         0x0004
+#define WIN_BG3         0x0008
+#define WIN_OBJ         0x0010
+#define WIN_ALL         0x001F
+#define WIN_BLD         0x0020
+
+#define BLD_BG0         0x0001
+#define BLD_BG1         0x0002
+#define BLD_BG2         0x0004
+#define BLD_BUILD(top, bot, mode) ((((bot) & 63) << 8) | (((mode) & 3) << 6) | ((top) & 63))
+#define BLDA_BUILD(eva, evb) (((eva) & 31) | (((evb) & 31) << 8))
+
+#define IRQ_VBLANK      0x0001
+#define IRQ_HBLANK      0x0002
+#define IRQ_VCOUNT      0x0004
+#define IRQ_TIMER0      0x0008
+#define IRQ_DMA0        0x0100
+#define IRQ_DMA3        0x0800
+
+enum eIrqIndex { II_VBLANK = 0, II_HBLANK, II_VCOUNT, II_TIMER0, II_TIMER1, II_TIMER2, II_TIMER3, II_SERIAL, II_DMA0, II_DMA1, II_DMA2, II_DMA3, II_KEYPAD, II_GAMEPAK, II_MAX };
+
+#define DMA_DST_INC     0
+#define DMA_DST_DEC     0x00200000
+#define DMA_DST_FIXED   0x00400000
+#define DMA_DST_RELOAD  0x00600000
+#define DMA_SRC_INC     0
+#define DMA_SRC_FIXED   0x01000000
+#define DMA_REPEAT      0x02000000
+#define DMA_16          0
+#define DMA_32          0x04000000
+#define DMA_NOW         0
+#define DMA_AT_VBLANK   0x10000000
+#define DMA_AT_HBLANK   0x20000000
+#define DMA_IRQ         0x40000000
+#define DMA_ENABLE      0x80000000
+#define DMA_CPY16       (DMA_NOW | DMA_16)
+#define DMA_CPY32       (DMA_NOW | DMA_32)
+#define DMA_HDMA        (DMA_ENABLE | DMA_REPEAT | DMA_AT_HBLANK | DMA_DST_RELOAD)
+
+#define TM_FREQ_1       0
+#define TM_FREQ_64      0x0001
+#define TM_FREQ_256     0x0002
+#define TM_FREQ_1024    0x0003
+#define TM_CASCADE      0x0004
+#define TM_IRQ          0x0040
+#define TM_ENABLE       0x0080
+
+#define ATTR0_REG       0
+#define ATTR0_AFF       0x0100
+#define ATTR0_HIDE      0x0200
+#define ATTR0_AFF_DBL   0x0300
+#define ATTR0_AFF_DBL_BIT 0x0200
+#define ATTR0_MODE_MASK 0x0300
+#define ATTR0_4BPP      0
+#define ATTR0_8BPP      0x2000
+#define ATTR0_SQUARE    0
+#define ATTR0_WIDE      0x4000
+#define ATTR0_TALL      0x8000
+#define ATTR0_Y_MASK    0x00FF
+#define ATTR1_X_MASK    0x01FF
+#define ATTR1_AFF_ID_MASK 0x3E00
+#define ATTR1_AFF_ID_SHIFT 9
+#define ATTR1_AFF_ID(n) ((n) << ATTR1_AFF_ID_SHIFT)
+#define ATTR1_SIZE_8    0
+#define ATTR1_SIZE_16   0x4000
+#define ATTR1_SIZE_32   0x8000
+#define ATTR1_SIZE_64   0xC000
+#define ATTR1_SIZE_32x32 ATTR1_SIZE_32
+#define ATTR2_ID_MASK   0x03FF
+#define ATTR2_PRIO(n)   ((n) << 10)
+#define ATTR2_PALBANK_MASK 0xF000
+#define ATTR2_PALBANK_SHIFT 12
+#define ATTR2_PALBANK(n) ((n) << ATTR2_PALBANK_SHIFT)
+
+#define SE_HFLIP        0x0400
+#define SE_VFLIP        0x0800
+#define SE_PALBANK_MASK 0xF000
+#define SE_PALBANK_SHIFT 12
+#define SE_PALBANK(n)   ((n) << SE_PALBANK_SHIFT)
+
+#define SCREEN_WIDTH    240
+#define SCREEN_HEIGHT   160
+
+#define RGB15(r, g, b)  ((r) + ((g) << 5) + ((b) << 10))
+#define CLR_BLACK       0x0000
+#define CLR_WHITE       0x7FFF
+
+#define KEY_A           0x0001
+#define KEY_B           0x0002
+#define KEY_SELECT      0x0004
+#define KEY_START       0x0008
+#define KEY_RIGHT       0x0010
+#define KEY_LEFT        0x0020
+#define KEY_UP          0x0040
+#define KEY_DOWN        0x0080
+#define KEY_R           0x0100
+#define KEY_L           0x0200
+#define KEY_MASK        0x03FF
+#define KEY_ANY         0x03FF
+#define KEY_DIR         0x00F0
+enum eKeyIndex { KI_A = 0, KI_B, KI_SELECT, KI_START, KI_RIGHT, KI_LEFT, KI_UP, KI_DOWN, KI_R, KI_L, KI_MAX };
+
+// ---- Fixed point -----------------------------------------------------------
+#define FIX_SHIFT       8
+#define FIX_SCALE       (1 << FIX_SHIFT)
+#define FIX_ONE         FIX_SCALE
+#define FIX_MASK        (FIX_SCALE - 1)
+#define FIX_SCALEF      ((float)FIX_SCALE)
+
+INLINE FIXED int2fx(int d) { return d << FIX_SHIFT; }
+INLINE FIXED float2fx(float f) { return (FIXED)(f * FIX_SCALEF); }
+INLINE int fx2int(FIXED fx) { return fx / FIX_SCALE; }
+INLINE FIXED fxmul(FIXED a, FIXED b) { return (a * b) >> FIX_SHIFT; }
+INLINE FIXED fxdiv(FIXED a, FIXED b) { return (a * FIX_SCALE) / b; }
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+#define clamp(x, lo, hi) ((x) < (lo) ? (lo) : ((x) >= (hi) ? ((hi) - 1) : (x)))
+
+#define BIT(n) (1 << (n))
+INLINE int bit_tribool(u32 flags, uint plus, uint minus) { return ((flags >> plus) & 1) - ((flags >> minus) & 1); }
+
+extern s16 sin_lut[514]; // Filled in at startup, const in the real libtonc
+INLINE s32 lu_sin(uint theta) { return sin_lut[(theta >> 7) & 0x1FF]; }
+INLINE s32 lu_cos(uint theta) { return sin_lut[((theta >> 7) + 128) & 0x1FF]; }
+
+// ---- Core copies -----------------------------------------------------------
+void memcpy16(void *dst, const void *src, uint hwcount);
+void memcpy32(void *dst, const void *src, uint wcount);
+void memset16(void *dst, u16 hw, uint hwcount);
+void memset32(void *dst, u32 wd, uint wcount);
+#define GRIT_CPY(dst, name) memcpy16(dst, name, name##Len / 2)
+
+INLINE void dma_cpy(void *dst, const void *src, uint count, uint ch, u32 mode)
+{
+    (void)ch;
+    uint size = (mode & DMA_32) ? 4 : 2;
+    if (mode & DMA_SRC_FIXED)
+    {
+        for (uint i = 0; i < count; i++)
+            memcpy((u8 *)dst + i * size, src, size);
+        return;
+    }
+    memcpy(dst, src, count * size);
+}
+#define dma3_cpy(dst, src, size) memcpy(dst, src, size)
+#define dma3_fill(dst, fill, size) memset32(dst, fill, (size) / 4)
+
+// ---- Interrupts / BIOS -----------------------------------------------------
+void irq_init(fnptr isr);
+fnptr irq_add(enum eIrqIndex irq_id, fnptr isr);
+fnptr irq_delete(enum eIrqIndex irq_id);
+void VBlankIntrWait(void);
+
+// ---- Keys ------------------------------------------------------------------
+extern u16 __key_curr, __key_prev;
+void key_poll(void);
+INLINE u32 key_curr_state(void) { return __key_curr; }
+INLINE u32 key_prev_state(void) { return __key_prev; }
+INLINE u32 key_is_down(u32 key) { return __key_curr & key; }
+INLINE u32 key_hit(u32 key) { return (__key_curr & ~__key_prev) & key; }
+INLINE u32 key_released(u32 key) { return (~__key_curr & __key_prev) & key; }
+
+// ---- Objects ---------------------------------------------------------------
+void oam_init(OBJ_ATTR *obj, uint count);
+void oam_copy(OBJ_ATTR *dst, const OBJ_ATTR *src, uint count);
+void obj_aff_copy(OBJ_AFFINE *dst, const OBJ_AFFINE *src, uint count);
+void obj_aff_rotscale(OBJ_AFFINE *oaff, FIXED sx, FIXED sy, u16 alpha);
+void obj_aff_identity(OBJ_AFFINE *oaff);
+
+INLINE OBJ_ATTR *obj_set_attr(OBJ_ATTR *obj, u16 a0, u16 a1, u16 a2)
+{
+    obj->attr0 = a0; obj->attr1 = a1; obj->attr2 = a2;
+    return obj;
+}
+INLINE void obj_set_pos(OBJ_ATTR *obj, int x, int y)
+{
+    obj->attr0 = (obj->attr0 & ~ATTR0_Y_MASK) | (y & ATTR0_Y_MASK);
+    obj->attr1 = (obj->attr1 & ~ATTR1_X_MASK) | (x & ATTR1_X_MASK);
+}
+INLINE void obj_hide(OBJ_ATTR *obj) { obj->attr0 = (obj->attr0 & ~ATTR0_MODE_MASK) | ATTR0_HIDE; }
+INLINE void obj_unhide(OBJ_ATTR *obj, u16 mode) { obj->attr0 = (obj->attr0 & ~ATTR0_MODE_MASK) | (mode & ATTR0_MODE_MASK); }
+
+// ---- Backgrounds -----------------------------------------------------------
+extern const BG_AFFINE bg_aff_default;
+void bg_rotscale_ex(BG_AFFINE *bgaff, const AFF_SRC_EX *asx);
+
+// ---- Colors ----------------------------------------------------------------
+void clr_rgbscale(COLOR *dst, const COLOR *src, uint nclrs, COLOR clr);
+
+// ---- Text engine -----------------------------------------------------------
+void tte_init_se(int bgnr, u16 bgcnt, SE se0, u32 clrs, u32 bupofs, const void *font, fnptr proc);
+void tte_init_con(void);
+int tte_printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+int tte_write(const char *text);
+void tte_set_pos(int x, int y);
+void tte_set_special(u16 special);
+void tte_erase_rect(int left, int top, int right, int bottom);
+void tte_erase_screen(void);
+
+#endif
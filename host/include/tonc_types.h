@@ -0,0 +1,68 @@
+// Host stand-in for libtonc's tonc_types.h
+#ifndef TONC_TYPES_H
+#define TONC_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef int8_t   s8;
+typedef int16_t  s16;
+typedef int32_t  s32;
+typedef volatile u8  vu8;
+typedef volatile u16 vu16;
+typedef volatile u32 vu32;
+typedef volatile s16 vs16;
+typedef volatile s32 vs32;
+typedef unsigned int uint;
+typedef s32 FIXED;
+typedef u16 COLOR;
+typedef u16 SE;
+
+#define INLINE static inline
+#define ALIGN(n) __attribute__((aligned(n)))
+#define ALIGN4 ALIGN(4)
+#define PACKED __attribute__((packed))
+#define IWRAM_CODE
+#define EWRAM_CODE
+#define IWRAM_DATA
+#define EWRAM_DATA
+#define EWRAM_BSS
+
+typedef struct { u32 data[8]; } TILE, TILE4;
+typedef struct { u32 data[16]; } TILE8;
+typedef TILE CHARBLOCK[512];
+typedef TILE8 CHARBLOCK8[256];
+typedef SE SCREENBLOCK[1024];
+typedef SE SCREENMAT[32][32];
+typedef COLOR PALBANK[16];
+
+typedef struct { int x, y; } POINT, POINT32;
+typedef struct { s16 x, y; } BG_POINT;
+typedef struct { int left, top, right, bottom; } RECT, RECT32;
+
+typedef struct OBJ_ATTR { u16 attr0, attr1, attr2; s16 fill; } ALIGN4 OBJ_ATTR;
+typedef struct OBJ_AFFINE
+{
+    u16 fill0[3]; s16 pa;
+    u16 fill1[3]; s16 pb;
+    u16 fill2[3]; s16 pc;
+    u16 fill3[3]; s16 pd;
+} ALIGN4 OBJ_AFFINE;
+
+typedef struct BG_AFFINE { s16 pa, pb, pc, pd; s32 dx, dy; } ALIGN4 BG_AFFINE;
+
+typedef struct AFF_SRC_EX
+{
+    s32 tex_x, tex_y;
+    s16 scr_x, scr_y;
+    s16 sx, sy;
+    u16 alpha;
+} ALIGN4 AFF_SRC_EX;
+
+typedef void (*fnptr)(void);
+
+#endif
@@ -0,0 +1,2 @@
+// Everything is declared in the host tonc.h
+#include "tonc.h"
@@ -0,0 +1,589 @@
+/* Headless batch simulator.
+ *
+ * Plays complete runs of the real game logic natively, driving it through the
+ * same key input a player would use, under a simple scripted policy:
+ * - Always play the blind, never skip.
+ * - Play what the best play solver finds scores the most with the held jokers.
+ *   If that is a pair or worse and discards are left, discard the lowest cards instead.
+ * - In the shop buy the first affordable joker while there is room, then move on.
+ *
+ * The game state is all globals, so every run is played in its own forked
+ * process, up to one per core at a time. Each run seeds the game from its own
+ * seed and only touches its own copy of the game and the RNG, so the results
+ * of a given seed don't depend on the number of jobs or on the other runs.
+ *
+ * Usage: balatro-sim [-n runs] [-s first_seed] [-j jobs] [-f max_frames_per_run]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include <tonc.h>
+
+#include "game.h"
+#include "card.h"
+#include "blind.h"
+#include "joker.h"
+#include "sprite.h"
+#include "affine_background.h"
+#include "hand_analysis.h"
+#include "scoring.h"
+#include "solver.h"
+#include "selection_grid.h"
+#include "list.h"
+#include "pool.h"
+#include "tile_cache.h"
+#include "pal_bank.h"
+#include "bg_assets.h"
+#include "vram_queue.h"
+#include "save.h"
+#include "util.h"
+
+#define DEFAULT_NUM_RUNS 1000
+#define DEFAULT_MAX_FRAMES (60 * 60 * 60) // An hour of play at 60 FPS, far longer than any run
+#define SIM_MAX_JOKER_IDS 64
+#define NEXT_ROUND_BTN_SEL_X 0 // Same as in game.c
+#define SHOP_TOP_ROW 1
+
+extern SelectionGrid shop_selection_grid; // Defined in game.c
+
+typedef const Pool *(*PoolGetFunc)(void);
+static const PoolGetFunc sim_pools[] =
+{
+    card_get_pool,
+    card_object_get_pool,
+    sprite_object_get_pool,
+    joker_get_pool,
+    joker_object_get_pool,
+};
+#define SIM_NUM_POOLS NUM_ELEM_IN_ARR(sim_pools)
+
+typedef struct
+{
+    int triggers;
+    int xmult_triggers;
+    long long chips;
+    long long mult;
+    long long money;
+} JokerStats;
+
+enum RunStatus
+{
+    RUN_CRASHED, // Set before the run starts so a run that dies early is reported as such
+    RUN_LOST,
+    RUN_WON,
+    RUN_STALLED, // Hit the frame limit, most likely the policy got stuck
+};
+
+typedef struct
+{
+    enum RunStatus status;
+    int ante; // The ante the run ended on
+    int hands_played;
+    int frames;
+    long long solver_plays; // Plays evaluated by the solver and the time it took
+    double solver_time;
+    JokerStats jokers[SIM_MAX_JOKER_IDS];
+    int pool_high_water[SIM_NUM_POOLS];
+    TileCacheStats tile_cache;
+    PalBankStats pal_bank;
+    BgAssetsStats bg_assets;
+    VramQueueStats vram_queue;
+    SaveStats save;
+    int leaks; // Blind selections that still had card objects or more joker objects than held jokers
+} RunResult;
+
+enum HandPlanStep
+{
+    PLAN_SELECT_CARDS,
+    PLAN_CHOOSE_BUTTON,
+    PLAN_CONFIRM,
+};
+
+typedef struct
+{
+    bool planned;
+    bool discard;
+    bool target[MAX_HAND_SIZE]; // The cards to select, by index in the hand
+    enum HandPlanStep step;
+} HandPlan;
+
+static double time_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void hand_plan_make(HandPlan *plan, RunResult *result)
+{
+    static Solver solver;
+    CardObject **hand = get_hand_array();
+    int hand_size = hand_get_size();
+
+    Card *hand_cards[MAX_HAND_SIZE];
+    for (int i = 0; i < hand_size; i++)
+    {
+        hand_cards[i] = hand[i]->card;
+    }
+
+    double start = time_now();
+    solver_start(&solver, hand_cards, hand_size, get_joker_dispatch());
+    solver_solve(&solver);
+    result->solver_time += time_now() - start;
+    result->solver_plays += solver.num_evaluated;
+
+    int best_mask = solver.best_mask;
+
+    memset(plan->target, 0, sizeof(plan->target));
+    plan->discard = false;
+    plan->step = PLAN_SELECT_CARDS;
+    plan->planned = true;
+
+    if (get_num_discards_remaining() > 0 && (solver.best_hand_type == HIGH_CARD || solver.best_hand_type == PAIR))
+    {
+        // Discard the lowest cards that aren't part of the best hand
+        int num_discarded = 0;
+        while (num_discarded < MAX_SELECTION_SIZE)
+        {
+            int lowest = UNDEFINED;
+            for (int i = 0; i < hand_size; i++)
+            {
+                if (!(best_mask & (1 << i)) && !plan->target[i]
+                    && (lowest == UNDEFINED || card_get_value(hand[i]->card) < card_get_value(hand[lowest]->card)))
+                {
+                    lowest = i;
+                }
+            }
+
+            if (lowest == UNDEFINED)
+                break;
+
+            plan->target[lowest] = true;
+            num_discarded++;
+        }
+
+        if (num_discarded > 0)
+        {
+            plan->discard = true;
+            return;
+        }
+    }
+
+    for (int i = 0; i < hand_size; i++)
+    {
+        plan->target[i] = best_mask & (1 << i);
+    }
+}
+
+static u32 policy_hand_select_key(HandPlan *plan, RunResult *result)
+{
+    if (!plan->planned)
+    {
+        hand_plan_make(plan, result);
+    }
+
+    switch (plan->step)
+    {
+        case PLAN_SELECT_CARDS:
+        {
+            CardObject **hand = get_hand_array();
+            for (int i = 0; i < hand_get_size(); i++)
+            {
+                if (card_object_is_selected(hand[i]) == plan->target[i])
+                    continue;
+
+                // Left moves the focus up the hand, see game_playing_process_hand_select_input()
+                int focus = hand_get_focus();
+                if (focus < i)
+                    return KEY_LEFT;
+                if (focus > i)
+                    return KEY_RIGHT;
+                return SELECT_CARD;
+            }
+
+            plan->step = PLAN_CHOOSE_BUTTON;
+            return KEY_DOWN;
+        }
+        case PLAN_CHOOSE_BUTTON:
+            plan->step = PLAN_CONFIRM;
+            return plan->discard ? KEY_RIGHT : KEY_LEFT;
+        case PLAN_CONFIRM:
+            return SELECT_CARD;
+    }
+
+    return 0;
+}
+
+static u32 policy_shop_key(void)
+{
+    const JokerObjectList *shop_jokers = get_shop_jokers();
+    int target_x = NEXT_ROUND_BTN_SEL_X;
+
+    if (get_jokers()->size < MAX_JOKERS_HELD_SIZE)
+    {
+        for (int i = 0; i < shop_jokers->size; i++)
+        {
+            JokerObject *joker_object = shop_jokers->items[i];
+            if (joker_object->joker->value <= get_money())
+            {
+                target_x = i + 1; // + 1 for the next round button
+                break;
+            }
+        }
+    }
+
+    // Input is ignored until the shop is ready, the same key is simply pressed again next time
+    Selection selection = shop_selection_grid.selection;
+    if (selection.y < SHOP_TOP_ROW)
+        return KEY_DOWN;
+    if (selection.y > SHOP_TOP_ROW)
+        return KEY_UP;
+    if (selection.x < target_x)
+        return KEY_RIGHT;
+    if (selection.x > target_x)
+        return KEY_LEFT;
+    return SELECT_CARD;
+}
+
+// Returns the key to press this frame, keys are only ever pressed for one frame at a time
+static u32 policy_get_key(HandPlan *plan, RunResult *result)
+{
+    if (game_get_state() != GAME_PLAYING || hand_get_state() != HAND_SELECT)
+    {
+        plan->planned = false;
+    }
+
+    switch (game_get_state())
+    {
+        case GAME_PLAYING:
+            return hand_get_state() == HAND_SELECT ? policy_hand_select_key(plan, result) : 0;
+        case GAME_SHOP:
+            return policy_shop_key();
+        case GAME_SPLASH_SCREEN:
+        case GAME_MAIN_MENU:
+        case GAME_BLIND_SELECT:
+        case GAME_ROUND_END:
+            return SELECT_CARD;
+        default:
+            return 0;
+    }
+}
+
+static void run_record_score(RunResult *result, const ScoreResult *score_result)
+{
+    const JokerObjectList *jokers = get_jokers();
+
+    result->hands_played++;
+    for (int i = 0; i < score_result->num_events; i++)
+    {
+        const ScoringEvent *event = &score_result->events[i];
+        if (event->type != SCORING_EVENT_JOKER)
+            continue;
+
+        JokerObject *joker_object = jokers->items[event->joker_idx];
+        JokerStats *stats = &result->jokers[joker_object->joker->id];
+        stats->triggers++;
+        stats->chips += event->effect.chips;
+        stats->mult += event->effect.mult;
+        stats->money += event->effect.money;
+        if (event->effect.xmult > 0)
+        {
+            stats->xmult_triggers++;
+        }
+    }
+}
+
+// Between rounds no card should be on screen and the only jokers left are the held ones
+static bool run_check_leaks(void)
+{
+    int num_card_objects = pool_get_num_in_use(card_object_get_pool());
+    int num_joker_objects = pool_get_num_in_use(joker_object_get_pool());
+    return num_card_objects == 0 && num_joker_objects == get_jokers()->size;
+}
+
+static void sim_run(int seed, int max_frames, RunResult *result)
+{
+    // Same as init() in main.c minus the display and sound setup
+    affine_background_init();
+    sprite_init();
+    blind_init();
+    game_init();
+
+    HandPlan plan = {0};
+    enum PlayState prev_play_state = PLAY_PLAYING;
+    enum GameState prev_game_state = game_get_state();
+    enum RunStatus status = RUN_STALLED;
+
+    for (result->frames = 0; result->frames < max_frames; result->frames++)
+    {
+        enum GameState game_state = game_get_state();
+        if (game_state == GAME_LOSE || game_state == GAME_WIN)
+        {
+            status = game_state == GAME_WIN ? RUN_WON : RUN_LOST;
+            break;
+        }
+
+        // Release every other frame so each press registers as a key hit
+        u32 keys = result->frames % 2 == 0 ? policy_get_key(&plan, result) : 0;
+        if (game_state == GAME_MAIN_MENU && keys != 0)
+        {
+            // The run is seeded from here once play is pressed
+            set_seed(seed);
+        }
+
+        affine_background_vblank();
+        vram_queue_flush();
+        REG_KEYINPUT = ~keys & KEY_MASK;
+        key_poll();
+        affine_background_update();
+        game_update();
+        save_update();
+        sprite_draw();
+
+        enum PlayState play_state = play_get_state();
+        if (play_state == PLAY_SCORING && prev_play_state != PLAY_SCORING)
+        {
+            run_record_score(result, get_score_result());
+        }
+        prev_play_state = play_state;
+
+        if (game_get_state() == GAME_BLIND_SELECT && prev_game_state != GAME_BLIND_SELECT && !run_check_leaks())
+        {
+            result->leaks++;
+        }
+        prev_game_state = game_get_state();
+    }
+
+    for (int i = 0; i < SIM_NUM_POOLS; i++)
+    {
+        result->pool_high_water[i] = pool_get_high_water(sim_pools[i]());
+    }
+    result->tile_cache = *tile_cache_get_stats();
+    result->pal_bank = *pal_bank_get_stats();
+    result->bg_assets = *bg_assets_get_stats();
+    result->vram_queue = *vram_queue_get_stats();
+    result->save = *save_get_stats();
+
+    result->ante = get_ante();
+    result->status = status; // Last, so a run that dies halfway stays marked as crashed
+}
+
+static void print_report(const RunResult *results, int num_runs, int first_seed, int num_jobs, double elapsed)
+{
+    int runs_reached[MAX_ANTE + 2] = {0};
+    int runs_cleared[MAX_ANTE + 2] = {0};
+    int num_won = 0, num_stalled = 0, num_crashed = 0;
+    long long total_frames = 0, total_hands = 0, solver_plays = 0;
+    double solver_time = 0;
+    JokerStats jokers[SIM_MAX_JOKER_IDS] = {0};
+    int pool_high_water[SIM_NUM_POOLS] = {0};
+    int num_leaking = 0;
+    long long tile_hits = 0, tile_misses = 0, tile_evictions = 0;
+    long long pal_hits = 0, pal_misses = 0, pal_evictions = 0, pal_failures = 0;
+    long long bg_hits = 0, bg_loads = 0;
+    long long vram_bytes = 0, vram_overflows = 0, vram_forced_flushes = 0;
+    int vram_max_depth = 0;
+    long long save_journal = 0, save_snapshots = 0, save_skipped = 0, save_bytes = 0;
+
+    for (int i = 0; i < num_runs; i++)
+    {
+        const RunResult *result = &results[i];
+        if (result->status == RUN_CRASHED)
+        {
+            fprintf(stderr, "seed %d crashed\n", first_seed + i);
+            num_crashed++;
+            continue;
+        }
+
+        num_won += result->status == RUN_WON;
+        num_stalled += result->status == RUN_STALLED;
+        total_frames += result->frames;
+        total_hands += result->hands_played;
+        solver_plays += result->solver_plays;
+        solver_time += result->solver_time;
+
+        for (int ante = 1; ante <= result->ante && ante <= MAX_ANTE; ante++)
+        {
+            runs_reached[ante]++;
+            if (ante < result->ante || result->status == RUN_WON)
+            {
+                runs_cleared[ante]++;
+            }
+        }
+
+        for (int j = 0; j < SIM_NUM_POOLS; j++)
+        {
+            if (result->pool_high_water[j] > pool_high_water[j])
+            {
+                pool_high_water[j] = result->pool_high_water[j];
+            }
+        }
+
+        tile_hits += result->tile_cache.hits;
+        tile_misses += result->tile_cache.misses;
+        tile_evictions += result->tile_cache.evictions;
+
+        pal_hits += result->pal_bank.hits;
+        pal_misses += result->pal_bank.misses;
+        pal_evictions += result->pal_bank.evictions;
+        pal_failures += result->pal_bank.failures;
+
+        bg_hits += result->bg_assets.hits;
+        bg_loads += result->bg_assets.loads;
+
+        vram_bytes += result->vram_queue.bytes_moved;
+        vram_overflows += result->vram_queue.overflows;
+        vram_forced_flushes += result->vram_queue.forced_flushes;
+        if (result->vram_queue.max_depth > vram_max_depth)
+        {
+            vram_max_depth = result->vram_queue.max_depth;
+        }
+
+        save_journal += result->save.journal_writes;
+        save_snapshots += result->save.snapshot_writes;
+        save_skipped += result->save.skipped_writes;
+        save_bytes += result->save.bytes_written;
+
+        if (result->leaks > 0)
+        {
+            fprintf(stderr, "seed %d leaked objects\n", first_seed + i);
+            num_leaking++;
+        }
+
+        for (int id = 0; id < SIM_MAX_JOKER_IDS; id++)
+        {
+            jokers[id].triggers += result->jokers[id].triggers;
+            jokers[id].xmult_triggers += result->jokers[id].xmult_triggers;
+            jokers[id].chips += result->jokers[id].chips;
+            jokers[id].mult += result->jokers[id].mult;
+            jokers[id].money += result->jokers[id].money;
+        }
+    }
+
+    printf("runs: %d (seeds %d-%d), jobs: %d\n", num_runs, first_seed, first_seed + num_runs - 1, num_jobs);
+    printf("time: %.2fs, %.1f runs/s, %.0f hands/s, %.0f frames/s\n",
+           elapsed, num_runs / elapsed, total_hands / elapsed, total_frames / elapsed);
+    printf("solver: %lld plays evaluated, %.0f plays/s per job\n", solver_plays, solver_time > 0 ? solver_plays / solver_time : 0);
+    printf("won: %d (%.1f%%), stalled: %d, crashed: %d\n", num_won, 100.0 * num_won / num_runs, num_stalled, num_crashed);
+
+    printf("\nante  reached  cleared  win rate\n");
+    for (int ante = 1; ante <= MAX_ANTE; ante++)
+    {
+        double rate = runs_reached[ante] ? 100.0 * runs_cleared[ante] / runs_reached[ante] : 0;
+        printf("%4d  %7d  %7d  %7.1f%%\n", ante, runs_reached[ante], runs_cleared[ante], rate);
+    }
+
+    printf("\njoker  triggers   +chips    +mult  xmult triggers   +money\n");
+    for (int id = 0; id < SIM_MAX_JOKER_IDS; id++)
+    {
+        if (jokers[id].triggers == 0)
+            continue;
+        printf("%5d  %8d  %7lld  %7lld  %14d  %7lld\n", id, jokers[id].triggers,
+               jokers[id].chips, jokers[id].mult, jokers[id].xmult_triggers, jokers[id].money);
+    }
+
+    printf("\npool                capacity  high water\n");
+    for (int i = 0; i < SIM_NUM_POOLS; i++)
+    {
+        const Pool *pool = sim_pools[i]();
+        printf("%-18s  %8d  %10d\n", pool->name, pool_get_capacity(pool), pool_high_water[i]);
+    }
+    printf("runs leaking objects: %d\n", num_leaking);
+
+    long long tile_acquires = tile_hits + tile_misses;
+    printf("\ntile cache: %lld hits (%.1f%%), %lld misses, %lld evictions\n", tile_hits,
+           tile_acquires ? 100.0 * tile_hits / tile_acquires : 0, tile_misses, tile_evictions);
+    printf("palette banks: %lld hits, %lld misses, %lld evictions, %lld out of banks\n",
+           pal_hits, pal_misses, pal_evictions, pal_failures);
+    printf("background tilesets: %lld shown resident, %lld loaded\n", bg_hits, bg_loads);
+    printf("vram queue: %.0f bytes/frame, max depth %d, %lld frames over budget, %lld forced flushes\n",
+           total_frames ? (double)vram_bytes / total_frames : 0, vram_max_depth, vram_overflows, vram_forced_flushes);
+
+    long long saves = save_journal + save_snapshots;
+    printf("saves: %lld as changed bytes, %lld as full images, %lld unchanged, %.0f bytes/save\n",
+           save_journal, save_snapshots, save_skipped, saves ? (double)save_bytes / saves : 0);
+}
+
+int main(int argc, char *argv[])
+{
+    int num_runs = DEFAULT_NUM_RUNS;
+    int first_seed = 1;
+    int num_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_frames = DEFAULT_MAX_FRAMES;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:j:f:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': num_runs = atoi(optarg); break;
+            case 's': first_seed = atoi(optarg); break;
+            case 'j': num_jobs = atoi(optarg); break;
+            case 'f': max_frames = atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-n runs] [-s first_seed] [-j jobs] [-f max_frames_per_run]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (num_runs <= 0 || num_jobs <= 0 || max_frames <= 0)
+    {
+        fprintf(stderr, "runs, jobs and max frames must be positive\n");
+        return EXIT_FAILURE;
+    }
+
+    if (get_joker_registry_size() > SIM_MAX_JOKER_IDS)
+    {
+        fprintf(stderr, "SIM_MAX_JOKER_IDS is too small for the %zu registered jokers\n", get_joker_registry_size());
+        return EXIT_FAILURE;
+    }
+
+    // Shared with the run processes so they can write their results directly
+    RunResult *results = mmap(NULL, num_runs * sizeof(RunResult), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (results == MAP_FAILED)
+    {
+        perror("mmap");
+        return EXIT_FAILURE;
+    }
+
+    double start = time_now();
+    int num_running = 0;
+
+    for (int i = 0; i < num_runs; i++)
+    {
+        if (num_running == num_jobs)
+        {
+            wait(NULL);
+            num_running--;
+        }
+
+        results[i].status = RUN_CRASHED;
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            sim_run(first_seed + i, max_frames, &results[i]);
+            _exit(EXIT_SUCCESS);
+        }
+        else if (pid < 0)
+        {
+            perror("fork");
+            break;
+        }
+        num_running++;
+    }
+
+    while (num_running-- > 0)
+    {
+        wait(NULL);
+    }
+
+    print_report(results, num_runs, first_seed, num_jobs, time_now() - start);
+
+    munmap(results, num_runs * sizeof(RunResult));
+    return EXIT_SUCCESS;
+}
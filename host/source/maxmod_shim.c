@@ -0,0 +1,22 @@
+#include "maxmod.h"
+
+void mmInitDefault(mm_addr soundbank, mm_word number_of_channels)
+{
+}
+
+void mmStart(mm_word module_ID, mm_pmode mode)
+{
+}
+
+void mmFrame(void)
+{
+}
+
+void mmVBlank(void)
+{
+}
+
+mm_sfxhand mmEffectEx(mm_sound_effect *sound)
+{
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "tonc.h"
+
+#define SIN_LUT_SIZE 512
+#define SIN_LUT_ONE 4096 // lu_sin() returns .12 fixed point
+
+u8 shim_io[0x400];
+u8 shim_pal[0x400];
+u8 shim_vram[0x18000];
+u8 shim_oam[0x400];
+u8 shim_sram[0x10000];
+
+u16 __key_curr, __key_prev;
+
+s16 sin_lut[514];
+const BG_AFFINE bg_aff_default = { FIX_ONE, 0, 0, FIX_ONE, 0, 0 };
+
+__attribute__((constructor))
+static void sin_lut_init(void)
+{
+    for (int i = 0; i < (int)(sizeof(sin_lut) / sizeof(sin_lut[0])); i++)
+    {
+        sin_lut[i] = (s16)lround(sin(2 * M_PI * i / SIN_LUT_SIZE) * SIN_LUT_ONE);
+    }
+}
+
+// Core
+
+void memcpy16(void *dst, const void *src, uint hwcount)
+{
+    memmove(dst, src, hwcount * sizeof(u16));
+}
+
+void memcpy32(void *dst, const void *src, uint wcount)
+{
+    memmove(dst, src, wcount * sizeof(u32));
+}
+
+void memset16(void *dst, u16 hw, uint hwcount)
+{
+    u16 *d = dst;
+    while (hwcount--)
+        *d++ = hw;
+}
+
+void memset32(void *dst, u32 wd, uint wcount)
+{
+    u32 *d = dst;
+    while (wcount--)
+        *d++ = wd;
+}
+
+// Interrupts and BIOS, there is no hardware to wait for
+
+void irq_init(fnptr isr)
+{
+}
+
+fnptr irq_add(enum eIrqIndex irq_id, fnptr isr)
+{
+    return isr;
+}
+
+fnptr irq_delete(enum eIrqIndex irq_id)
+{
+    return NULL;
+}
+
+void VBlankIntrWait(void)
+{
+}
+
+// Keys, REG_KEYINPUT is active low like on hardware so the caller drives input by writing to it
+
+void key_poll(void)
+{
+    __key_prev = __key_curr;
+    __key_curr = ~REG_KEYINPUT & KEY_MASK;
+}
+
+// Objects
+
+void oam_init(OBJ_ATTR *obj, uint count)
+{
+    // Like libtonc, clears the fill too and copies the hidden entries to OAM
+    for (uint i = 0; i < count; i++)
+    {
+        obj[i] = (OBJ_ATTR){ATTR0_HIDE, 0, 0, 0};
+    }
+    oam_copy(oam_mem, obj, count);
+}
+
+void oam_copy(OBJ_ATTR *dst, const OBJ_ATTR *src, uint count)
+{
+    memmove(dst, src, count * sizeof(OBJ_ATTR));
+}
+
+void obj_aff_copy(OBJ_AFFINE *dst, const OBJ_AFFINE *src, uint count)
+{
+    // Only the matrix entries, the fillers overlap the OBJ_ATTRs
+    for (uint i = 0; i < count; i++)
+    {
+        dst[i].pa = src[i].pa;
+        dst[i].pb = src[i].pb;
+        dst[i].pc = src[i].pc;
+        dst[i].pd = src[i].pd;
+    }
+}
+
+void obj_aff_identity(OBJ_AFFINE *oaff)
+{
+    oaff->pa = FIX_ONE;
+    oaff->pb = 0;
+    oaff->pc = 0;
+    oaff->pd = FIX_ONE;
+}
+
+void obj_aff_rotscale(OBJ_AFFINE *oaff, FIXED sx, FIXED sy, u16 alpha)
+{
+    int ss = lu_sin(alpha), cc = lu_cos(alpha);
+
+    oaff->pa = cc * sx >> 12;
+    oaff->pb = -ss * sx >> 12;
+    oaff->pc = ss * sy >> 12;
+    oaff->pd = cc * sy >> 12;
+}
+
+// Backgrounds
+
+void bg_rotscale_ex(BG_AFFINE *bgaff, const AFF_SRC_EX *asx)
+{
+    int sx = asx->sx, sy = asx->sy;
+    int ss = lu_sin(asx->alpha), cc = lu_cos(asx->alpha);
+    FIXED pa = cc * sx >> 12, pb = -ss * sx >> 12, pc = ss * sy >> 12, pd = cc * sy >> 12;
+
+    bgaff->pa = pa;
+    bgaff->pb = pb;
+    bgaff->pc = pc;
+    bgaff->pd = pd;
+    bgaff->dx = asx->tex_x - (pa * asx->scr_x + pb * asx->scr_y);
+    bgaff->dy = asx->tex_y - (pc * asx->scr_x + pd * asx->scr_y);
+}
+
+// Colors
+
+void clr_rgbscale(COLOR *dst, const COLOR *src, uint nclrs, COLOR clr)
+{
+    memmove(dst, src, nclrs * sizeof(COLOR));
+}
+
+// Text engine, nothing is drawn but the formatting still runs so it shows up when profiling
+
+void tte_init_se(int bgnr, u16 bgcnt, SE se0, u32 clrs, u32 bupofs, const void *font, fnptr proc)
+{
+}
+
+void tte_init_con(void)
+{
+}
+
+int tte_printf(const char *format, ...)
+{
+    char buffer[256];
+    va_list args;
+
+    va_start(args, format);
+    int len = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    return len;
+}
+
+int tte_write(const char *text)
+{
+    return strlen(text);
+}
+
+void tte_set_pos(int x, int y)
+{
+}
+
+void tte_set_special(u16 special)
+{
+}
+
+void tte_erase_rect(int left, int top, int right, int bottom)
+{
+}
+
+void tte_erase_screen(void)
+{
+}
@@ -0,0 +1,129 @@
+/* Checks the packed HandDistribution classifier against the histogram one it replaced
+ * (include/hand_histogram.h) on every multiset of 1 to MAX_SELECTION_SIZE cards.
+ * Cards may repeat, a deck can hold more than one of a card.
+ * Each predicate is compared too, not only the resulting hand type, and removing a card
+ * is checked against the distribution built without it.
+ *
+ * Usage: hand_analysis_test, exits with 1 on the first mismatches
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <tonc.h>
+
+#include "card.h"
+#include "game.h"
+#include "hand_analysis.h"
+#include "hand_histogram.h"
+
+#define NUM_CARDS (NUM_SUITS * NUM_RANKS)
+#define MAX_REPORTED_MISMATCHES 10
+
+static Card cards[MAX_SELECTION_SIZE];
+static long num_hands = 0;
+static long num_mismatches = 0;
+static long hand_type_counts[FLUSH_FIVE + 1];
+
+static void report_mismatch(int num_cards, const char *what, int packed, int histogram)
+{
+    num_mismatches++;
+    if (num_mismatches > MAX_REPORTED_MISMATCHES)
+        return;
+
+    printf("mismatch in %s: packed %d, histogram %d, cards", what, packed, histogram);
+    for (int i = 0; i < num_cards; i++)
+    {
+        printf(" %d/%d", cards[i].rank, cards[i].suit);
+    }
+    printf("\n");
+}
+
+static void check(int num_cards, const char *what, int packed, int histogram)
+{
+    if (packed != histogram)
+    {
+        report_mismatch(num_cards, what, packed, histogram);
+    }
+}
+
+static void check_hand(int num_cards)
+{
+    HandDistribution dist;
+    u8 ranks[NUM_RANKS] = {0};
+    u8 suits[NUM_SUITS] = {0};
+
+    hand_distribution_clear(&dist);
+    for (int i = 0; i < num_cards; i++)
+    {
+        hand_distribution_add_card(&dist, &cards[i]);
+        hand_histogram_add_card(ranks, suits, &cards[i]);
+    }
+
+    for (int rank = 0; rank < NUM_RANKS; rank++)
+    {
+        check(num_cards, "rank count", hand_distribution_get_rank_count(&dist, rank), ranks[rank]);
+    }
+    for (int suit = 0; suit < NUM_SUITS; suit++)
+    {
+        check(num_cards, "suit count", hand_distribution_get_suit_count(&dist, suit), suits[suit]);
+    }
+
+    check(num_cards, "n of a kind", hand_contains_n_of_a_kind(&dist), hand_histogram_n_of_a_kind(ranks));
+    check(num_cards, "two pair", hand_contains_two_pair(&dist), hand_histogram_two_pair(ranks));
+    check(num_cards, "full house", hand_contains_full_house(&dist), hand_histogram_full_house(ranks));
+    check(num_cards, "straight", hand_contains_straight(&dist), hand_histogram_straight(ranks));
+    check(num_cards, "royal", hand_contains_royal(&dist), hand_histogram_royal(ranks));
+    check(num_cards, "flush", hand_contains_flush(&dist), hand_histogram_flush(suits));
+
+    enum HandType hand_type = hand_distribution_get_type(&dist);
+    check(num_cards, "hand type", hand_type, hand_histogram_get_type(ranks, suits));
+
+    // Taking the last card off again must give the distribution of the others, as the solver does
+    HandDistribution others;
+    hand_distribution_clear(&others);
+    for (int i = 0; i < num_cards - 1; i++)
+    {
+        hand_distribution_add_card(&others, &cards[i]);
+    }
+    hand_distribution_remove_card(&dist, &cards[num_cards - 1]);
+    check(num_cards, "remove rank counts", dist.rank_counts[0] == others.rank_counts[0] && dist.rank_counts[1] == others.rank_counts[1], true);
+    check(num_cards, "remove suit counts", dist.suit_counts, others.suit_counts);
+    check(num_cards, "remove rank mask", dist.rank_mask, others.rank_mask);
+
+    hand_type_counts[hand_type]++;
+    num_hands++;
+}
+
+// Every non-decreasing sequence of card indices, so each multiset once
+static void enumerate(int num_cards, int first_card)
+{
+    if (num_cards > 0)
+    {
+        check_hand(num_cards);
+    }
+    if (num_cards == MAX_SELECTION_SIZE)
+        return;
+
+    for (int card = first_card; card < NUM_CARDS; card++)
+    {
+        cards[num_cards].suit = card / NUM_RANKS;
+        cards[num_cards].rank = card % NUM_RANKS;
+        enumerate(num_cards + 1, card);
+    }
+}
+
+int main(void)
+{
+    enumerate(0, 0);
+
+    printf("hand_analysis_test: %ld hands of 1 to %d cards, %ld mismatches\n", num_hands, MAX_SELECTION_SIZE, num_mismatches);
+    for (int hand_type = HIGH_CARD; hand_type <= FLUSH_FIVE; hand_type++)
+    {
+        if (hand_type_counts[hand_type] > 0)
+        {
+            printf("%-24s %8ld\n", hand_type_get_info(hand_type)->name, hand_type_counts[hand_type]);
+        }
+    }
+
+    return num_mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,162 @@
+/* Turns the power off after every byte of every save in a series and checks that the save
+ * read back by save_init() is either the one before or the one that was being written.
+ * Most saves change a few short runs of bytes and go to the journal, every so often one
+ * changes most of the image, and there are enough of them to fill the journal, so full
+ * images are written to both slots too.
+ *
+ * save.c is included rather than linked to walk its queued writes a byte at a time,
+ * save_update() writes SAVE_BYTES_PER_FRAME at once. Everything save.o defines is defined
+ * here, so the library's copy isn't linked.
+ *
+ * Usage: save_test, exits with 1 on the first mismatches
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../source/save.c"
+
+#define IMAGE_VERSION 1
+#define IMAGE_SIZE 256
+#define NUM_SAVES 300
+#define BIG_CHANGE_INTERVAL 16 // Every this many saves most of the image changes
+#define MAX_RUNS 6
+#define MAX_RUN_LEN 48
+#define MAX_REPORTED_FAILURES 10
+
+#define SRAM ((u8 *)(MEM_SRAM + SAVE_SRAM_OFFSET))
+
+static u8 images[NUM_SAVES + 1][IMAGE_SIZE]; // images[0] is the blank one before the first save
+static u8 sram_before[SAVE_SRAM_SIZE];
+static u32 rng_state = 1;
+static long num_cuts = 0;
+static long num_failures = 0;
+static int num_journal_writes = 0;
+static int num_snapshot_writes = 0;
+
+static u32 next_random(void)
+{
+    rng_state = rng_state * 1103515245 + 12345;
+    return rng_state >> 16;
+}
+
+static void make_image(int n)
+{
+    memcpy(images[n], images[n - 1], IMAGE_SIZE);
+
+    bool big = n % BIG_CHANGE_INTERVAL == 0;
+    int num_runs = big ? 1 : 1 + next_random() % MAX_RUNS;
+    int max_len = big ? IMAGE_SIZE : MAX_RUN_LEN;
+    for (int i = 0; i < num_runs; i++)
+    {
+        int start = big ? 0 : next_random() % IMAGE_SIZE;
+        int len = big ? IMAGE_SIZE : 1 + next_random() % max_len;
+        for (int j = start; j < start + len && j < IMAGE_SIZE; j++)
+        {
+            images[n][j] = next_random();
+        }
+    }
+}
+
+static int queued_bytes(void)
+{
+    int total = 0;
+    for (int i = 0; i < num_writes; i++)
+    {
+        total += writes[i].len;
+    }
+    return total;
+}
+
+// Does what save_update() does, but stops after count bytes
+static void write_queued_bytes(int count)
+{
+    for (int i = 0; i < num_writes && count > 0; i++)
+    {
+        for (int j = 0; j < writes[i].len && count > 0; j++, count--)
+        {
+            SAVE_SRAM[writes[i].sram_offset + j] = staging[writes[i].staging_offset + j];
+        }
+    }
+}
+
+// Starts over from SRAM as it was before save n and queues it
+static void start_save(int n)
+{
+    memcpy(SRAM, sram_before, SAVE_SRAM_SIZE);
+    save_init(IMAGE_VERSION, IMAGE_SIZE);
+    save_write(images[n]);
+}
+
+static void check_load(int n, int cut, bool complete)
+{
+    num_cuts++;
+    save_init(IMAGE_VERSION, IMAGE_SIZE);
+
+    u8 loaded[IMAGE_SIZE];
+    const char *result;
+    if (!save_load(loaded))
+        result = n == 1 && !complete ? NULL : "no save";
+    else if (memcmp(loaded, images[n], IMAGE_SIZE) == 0)
+        result = NULL;
+    else if (memcmp(loaded, images[n - 1], IMAGE_SIZE) == 0 && n > 1 && !complete)
+        result = NULL;
+    else
+        result = "another image";
+
+    if (result == NULL)
+        return;
+
+    num_failures++;
+    if (num_failures <= MAX_REPORTED_FAILURES)
+    {
+        printf("save %d cut after %d bytes%s: loaded %s\n", n, cut, complete ? " (complete)" : "", result);
+    }
+}
+
+static void check_save(int n)
+{
+    memcpy(sram_before, SRAM, SAVE_SRAM_SIZE);
+
+    start_save(n);
+    int total = queued_bytes();
+    for (int cut = 0; cut < total; cut++)
+    {
+        start_save(n);
+        write_queued_bytes(cut);
+        check_load(n, cut, false);
+    }
+
+    // Left in SRAM for the next save
+    int snapshot_writes = stats.snapshot_writes;
+    start_save(n);
+    if (stats.snapshot_writes != snapshot_writes)
+        num_snapshot_writes++;
+    else
+        num_journal_writes++;
+
+    save_finish_writes();
+    check_load(n, total, true);
+}
+
+int main(void)
+{
+    memset(SRAM, 0xFF, SAVE_SRAM_SIZE); // Blank SRAM
+
+    for (int n = 1; n <= NUM_SAVES; n++)
+    {
+        make_image(n);
+        check_save(n);
+    }
+
+    // A full journal starts a new full image besides those for the big changes
+    bool journal_filled = num_snapshot_writes > 1 + NUM_SAVES / BIG_CHANGE_INTERVAL;
+
+    printf("save_test: %d saves, %d to the journal, %d full images, %ld power cuts, %ld failures\n",
+           NUM_SAVES, num_journal_writes, num_snapshot_writes, num_cuts, num_failures);
+    if (!journal_filled)
+    {
+        printf("the journal was never filled\n");
+    }
+
+    return num_failures == 0 && journal_filled ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -16,8 +16,9 @@ enum AffineBackgroundID
 };
 
 void affine_background_init();
-IWRAM_CODE void affine_background_hblank();
-IWRAM_CODE void affine_background_update();
+// Starts showing the frame built by the last affine_background_update(), call at the start of VBlank
+void affine_background_vblank();
+void affine_background_update();
 void affine_background_set_color(COLOR color);
 // Must be called with an array of size at least  AFFINE_BG_PAL_LEN
 void affine_background_load_palette(const u16 *src);
@@ -0,0 +1,33 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/* Micro-benchmarks of the game's hot paths for builds made with `make bench`.
+ * The ROM boots as usual, plays into the first hand by pressing A, then times each
+ * kernel BENCH_ITERATIONS times with the TM2/TM3 cycle counter and interrupts off.
+ * The results are printed as CSV lines to mGBA's debug log:
+ *
+ *  bench,<kernel>,<iterations>,<avg cycles>,<min cycles>
+ *
+ * after which it calls Stop(), which `mgba-rom-test -S 3` exits on.
+ * scripts/bench_compare.py compares a log with scripts/bench_baseline.csv.
+ * Errors are logged as "bench: <error>" lines, they fail the comparison.
+ *
+ * Without BENCH the macro is empty and none of this is compiled.
+ */
+#define BENCH_ITERATIONS 32
+#define BENCH_CORPUS_SIZE 64 // Played hands for the hand type and joker kernels
+
+#ifdef BENCH
+
+// Never returns
+void bench_run(void);
+
+#define BENCH_RUN() bench_run()
+
+#else
+
+#define BENCH_RUN() ((void)0)
+
+#endif // BENCH
+
+#endif // BENCH_H
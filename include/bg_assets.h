@@ -0,0 +1,50 @@
+#ifndef BG_ASSETS_H
+#define BG_ASSETS_H
+
+#include <tonc.h>
+
+/* Keeps the background tilesets resident in VRAM, so changing backgrounds is mostly
+ * pointing the layer's BGxCNT at another charblock instead of copying 16KB of tiles.
+ * Each tileset has a fixed place, planned so the ones used during a run never overlap:
+ *
+ *  CBB 0   game background
+ *  CBB 1   shop background, or the main menu background
+ *  CBB 2   blind select background, or the affine main menu background
+ *  CBB 3   TTE font, the affine game background from BG_ASSETS_AFFINE_GAME_TILE,
+ *          the screenblocks from AFFINE_BG_SBB on
+ *
+ * Only the main menu evicts anything. After it the shop and blind select tilesets are loaded
+ * again the first time they're shown, through the VBlank queue so the load is spread over frames.
+ * The maps are still copied on every change, the game edits them in place.
+ */
+#define BG_ASSETS_NUM_CBBS 4
+#define BG_ASSETS_AFFINE_GAME_TILE 64 // In 8bpp tiles from the start of CBB 3, leaves 4KB for the TTE font
+
+enum BgAssetID
+{
+    BG_ASSET_GAME,
+    BG_ASSET_SHOP,
+    BG_ASSET_BLIND_SELECT,
+    BG_ASSET_MAIN_MENU,
+    BG_ASSET_AFFINE_GAME,
+    BG_ASSET_AFFINE_MAIN_MENU,
+    BG_ASSET_COUNT
+};
+
+typedef struct
+{
+    int hits;  // Shown backgrounds whose tiles were still resident
+    int loads; // Shown backgrounds whose tiles had to be copied
+} BgAssetsStats;
+
+/* Points the background layer of id at its tiles, loading them first if they were evicted.
+ * The map and palette are up to the caller.
+ */
+void bg_assets_show(enum BgAssetID id);
+
+// Index of the first tile of id within its CBB, to add to the tile indices of its map
+int bg_assets_get_first_tile(enum BgAssetID id);
+
+const BgAssetsStats *bg_assets_get_stats(void);
+
+#endif // BG_ASSETS_H
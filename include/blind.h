@@ -5,16 +5,6 @@
 
 #define MAX_ANTE 8 // The GBA's max uint value is around 4 billion, so we're going to not add endless mode for simplicity's sake
 
-#define SMALL_BLIND_PB 1
-#define BIG_BLIND_PB 2
-#define BOSS_BLIND_PB 3
-
-#define BLIND_SPRITE_OFFSET 16
-#define BLIND_SPRITE_COPY_SIZE BLIND_SPRITE_OFFSET * 8 // 8 ints per tile
-#define SMALL_BLIND_TID 960
-#define BIG_BLIND_TID (BLIND_SPRITE_OFFSET + SMALL_BLIND_TID)
-#define BOSS_BLIND_TID (BLIND_SPRITE_OFFSET + BIG_BLIND_TID)
-
 enum BlindColorIndex
 {
     BLIND_TEXT_COLOR_INDEX = 1,
@@ -49,13 +39,10 @@ enum BlindState
     BLIND_STATE_MAX,
 };
 
-// TODO: Move this to a common interface for other palettes
 typedef struct
 {
     const unsigned int* tiles;
-    const u16* palette;
-    u32 tid;
-    u32 pb;
+    const u16* palette; // Given a palette bank by the palette bank allocator while a token shows it
 } BlindGfxInfo;
 
 typedef struct
@@ -74,6 +61,7 @@ int blind_get_requirement(enum BlindType type, int ante);
 int blind_get_reward(enum BlindType type);
 u16 blind_get_color(enum BlindType type, enum BlindColorIndex index);
 
+// Returns NULL when there is no palette bank, tiles or sprite slot left for the token
 Sprite *blind_token_new(enum BlindType type, int x, int y, int sprite_index);
 
 #endif // BLIND_H
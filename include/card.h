@@ -5,12 +5,15 @@
 #include <maxmod.h>
 
 #include "sprite.h"
+#include "game.h"
+#include "pool.h"
+#include "util.h"
 
-#define CARD_TID 0
-#define CARD_SPRITE_OFFSET 16
-#define CARD_PB 0
 #define CARD_STARTING_LAYER 0
 
+#define MAX_CARD_OBJECTS (MAX_HAND_SIZE + MAX_SELECTION_SIZE + 2) // The hand, the played cards, the card being discarded and the main menu ace
+#define MAX_CARDS MAX_CARD_OBJECTS // A Card only exists while it's on screen, the deck and discard pile hold CardCodes
+
 // Card suits
 #define HEARTS 0
 #define CLUBS 1
@@ -37,6 +40,29 @@
 
 #define IMPOSSIBLY_HIGH_CARD_VALUE 100
 
+/* The deck and the discard pile store each card as a 16-bit code instead of a Card:
+ *
+ *  bits 0-3    rank
+ *  bits 4-5    suit
+ *  bits 6-8    enhancement
+ *  bits 9-11   edition
+ *  bits 12-14  seal
+ *
+ * 0 in the last three is none. Cards don't have those yet, the bits are kept for them.
+ */
+typedef u16 CardCode;
+
+#define CARD_CODE_RANK_SHIFT 0
+#define CARD_CODE_RANK_MASK (0xF << CARD_CODE_RANK_SHIFT)
+#define CARD_CODE_SUIT_SHIFT 4
+#define CARD_CODE_SUIT_MASK (0x3 << CARD_CODE_SUIT_SHIFT)
+#define CARD_CODE_ENHANCEMENT_SHIFT 6
+#define CARD_CODE_ENHANCEMENT_MASK (0x7 << CARD_CODE_ENHANCEMENT_SHIFT)
+#define CARD_CODE_EDITION_SHIFT 9
+#define CARD_CODE_EDITION_MASK (0x7 << CARD_CODE_EDITION_SHIFT)
+#define CARD_CODE_SEAL_SHIFT 12
+#define CARD_CODE_SEAL_MASK (0x7 << CARD_CODE_SEAL_SHIFT)
+
 // Card types
 typedef struct Card
 {
@@ -50,19 +76,39 @@ typedef struct CardObject
     SpriteObject *sprite_object;
 } CardObject;
 
+// CardCode functions
+static inline CardCode card_code_make(u8 suit, u8 rank)
+{
+    return (suit << CARD_CODE_SUIT_SHIFT) | (rank << CARD_CODE_RANK_SHIFT);
+}
+
+static inline u8 card_code_get_suit(CardCode code)
+{
+    return (code & CARD_CODE_SUIT_MASK) >> CARD_CODE_SUIT_SHIFT;
+}
+
+static inline u8 card_code_get_rank(CardCode code)
+{
+    return (code & CARD_CODE_RANK_MASK) >> CARD_CODE_RANK_SHIFT;
+}
+
 // Card functions
-void card_init();
+const Pool *card_get_pool(void);
+const Pool *card_object_get_pool(void);
 
 // Card methods
 Card *card_new(u8 suit, u8 rank);
+Card *card_new_from_code(CardCode code);
 void card_destroy(Card **card);
-u8 card_get_value(Card *card);
+CardCode card_get_code(const Card *card);
+ARM_IWRAM_CODE u8 card_get_value(Card *card);
 
 // CardObject methods
-CardObject *card_object_new(Card *card);
-void card_object_destroy(CardObject **card_object);
+CardObject *card_object_new(Card *card); // Takes ownership of card
+void card_object_destroy(CardObject **card_object); // Destroys its card too, get its code first to keep it
 void card_object_update(CardObject *card_object); // Update the card object position and scale
-void card_object_set_sprite(CardObject *card_object, int layer);
+// Returns false if there was no palette bank or tiles left, the card is then not shown until it's set again
+bool card_object_set_sprite(CardObject *card_object, int layer);
 void card_object_shake(CardObject* card_object, mm_word sound_id);
 
 void card_object_set_selected(CardObject* card_object, bool selected);
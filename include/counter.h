@@ -0,0 +1,44 @@
+#ifndef COUNTER_H
+#define COUNTER_H
+
+#include <tonc.h>
+
+#include "graphic_utils.h"
+
+/* Draws numbers straight into the TTE screenblock, one glyph per screen entry,
+ * without going through tte_printf() and its format parsing.
+ * The text is compared with what's already on screen and only the screen entries
+ * that differ are written, so redrawing a number that changed by a digit or two,
+ * as happens every scoring tick, costs next to nothing.
+ * What's on screen is read back instead of cached, so it's fine for other code to erase or
+ * print over a counter in between.
+ */
+
+// Room for a prefix, a minus sign, the digits and a suffix
+#define COUNTER_MAX_CHARS (INT_MAX_DIGITS + 3)
+
+enum CounterAlign
+{
+    COUNTER_ALIGN_LEFT,
+    COUNTER_ALIGN_RIGHT,  // Overflows to the left
+    COUNTER_ALIGN_CENTER, // Rounds to the tile on the left if it can't be centered exactly
+};
+
+typedef struct
+{
+    Rect rect;           // In pixels on the TTE layer, same as for tte_erase_rect_wrapper(), a single row of text
+    enum CounterAlign align;
+    u16 pb;              // Palette bank of the text, e.g. TTE_WHITE_PB
+    char prefix;         // Drawn right before the number e.g. '$', 0 for none
+    int abbreviate_from; // Values from this on are shown in thousands with a 'k', from 1000 times it in millions with an 'M'. 0 to never abbreviate
+} Counter;
+
+// Shows value in counter->rect, the rest of the rect is cleared
+void counter_draw(const Counter *counter, int value);
+
+/* Shows prefix and value left aligned at the pixel position (x, y), without clearing anything around them.
+ * Same as tte_printf("#{P:x,y; cx:pb000}%c%d", prefix, value), prefix can be 0 for none.
+ */
+void counter_draw_at(int x, int y, u16 pb, char prefix, int value);
+
+#endif // COUNTER_H
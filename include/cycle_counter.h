@@ -0,0 +1,33 @@
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+#include <tonc.h>
+
+/* A 32-bit count of CPU cycles, TM2 counts every cycle and TM3 counts TM2's overflows.
+ * Used by the frame profiler and the benchmarks, it wraps after about 4 minutes
+ * so only differences between two reads mean anything.
+ */
+INLINE void cycle_counter_init(void)
+{
+    REG_TM2CNT = 0;
+    REG_TM3CNT = 0;
+    REG_TM2D = 0;
+    REG_TM3D = 0;
+    REG_TM3CNT = TM_ENABLE | TM_CASCADE;
+    REG_TM2CNT = TM_ENABLE | TM_FREQ_1;
+}
+
+INLINE u32 cycle_counter_read(void)
+{
+    // TM3 may tick over between the two reads, read it again until it didn't
+    u16 hi, lo;
+    do
+    {
+        hi = REG_TM3D;
+        lo = REG_TM2D;
+    } while (hi != REG_TM3D);
+
+    return ((u32)hi << 16) | lo;
+}
+
+#endif // CYCLE_COUNTER_H
@@ -1,8 +1,10 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include "list.h"
+
 #define MAX_HAND_SIZE 16
-#define MAX_DECK_SIZE 52
+#define MAX_DECK_SIZE 512 // Room for cards added during a run, the deck and discard pile are 16 bits per card
 #define MAX_JOKERS_HELD_SIZE 5 // This doesn't account for negatives right now.
 #define MAX_SHOP_JOKERS 2 // TODO: Make this dynamic and allow for other items besides jokers
 #define MAX_SELECTION_SIZE 5
@@ -25,6 +27,7 @@
 #define SORT_HAND KEY_R
 #define PAUSE_GAME KEY_START // Not implemented
 #define SELL_KEY KEY_L
+#define APPLY_HINT KEY_SELECT
 
 enum GameState
 {
@@ -75,32 +78,58 @@ enum HandType
     FLUSH_FIVE
 };
 
+typedef struct
+{
+    const char *name; // As displayed, NULL for NONE
+    int base_chips;
+    int base_mult;
+} HandTypeInfo;
+
+const HandTypeInfo *hand_type_get_info(enum HandType hand_type);
+
 // Game functions
 void game_init();
 void game_update();
+void game_idle(); // Background work for the time left at the end of the frame
 void game_set_state(enum GameState new_game_state);
 
-// Forward declaration
-struct List; 
-typedef struct List List;
-
 // Utility functions for other files
 typedef struct CardObject CardObject; // forward declaration, actually declared in card.h
 typedef struct Card Card;
 typedef struct JokerObject JokerObject;
+typedef struct ScoreResult ScoreResult;
+typedef struct JokerDispatch JokerDispatch;
+
+// The held, shop and sold jokers, none of them has more than can be held
+LIST_DEFINE(JokerObject *, JokerObjectList, joker_object_list, MAX_JOKERS_HELD_SIZE)
+
 CardObject**    get_hand_array(void);
 int             get_hand_top(void);
 int             hand_get_size(void);
 CardObject**    get_played_array(void);
 int             get_played_top(void);
-List*           get_jokers(void);
+JokerObjectList* get_jokers(void);
+const JokerDispatch* get_joker_dispatch(void); // The held jokers by scoring phase
 bool            is_joker_owned(int joker_id);
 bool            card_is_face(Card *card);
+void            sort_cards(void);
+void            deck_shuffle(void);
 
 int get_deck_top(void);
 int get_num_discards_remaining(void);
 int get_num_hands_remaining(void);
 int get_money(void);
+int get_ante(void);
+int get_score(void);
+
+// State getters, mainly for driving the game from the host simulator
+enum GameState  game_get_state(void);
+enum HandState  hand_get_state(void);
+enum PlayState  play_get_state(void);
+int             hand_get_focus(void);
+JokerObjectList* get_shop_jokers(void); // Empty outside the shop
+const ScoreResult* get_score_result(void); // The last played hand's score, valid from PLAY_SCORING on
+void            set_seed(int seed);
 
 int get_game_speed(void);
 void set_game_speed(int new_game_speed);
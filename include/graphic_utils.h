@@ -16,13 +16,13 @@
 /* Reminder:
  *  Screen Base Block is the base for the screenblock entries i.e. tilemap
  *  Character Base Block is the base for the tiles themselves
+ * The background CBBs are handed out by bg_assets.h, the layout is described there.
  */
+#define MAIN_BG_IDX 1 // The index of the main background BGCNT register etc.
 #define MAIN_BG_SBB 31 
-#define MAIN_BG_CBB 1
 #define TTE_SBB 30
-#define TTE_CBB 0
-#define AFFINE_BG_SBB 2
-#define AFFINE_BG_CBB 2
+#define TTE_CBB 3
+#define AFFINE_BG_SBB 29
 #define PAL_ROW_LEN 16
 #define NUM_PALETTES 16
 
@@ -67,6 +67,12 @@
 // By default TTE characters occupy a single tile
 #define TTE_CHAR_SIZE TILE_SIZE
 
+/* Screen entries of the TTE layer as set up by tte_init_se() in main(),
+ * the default font has a tile per character starting from ' ' at tile 0 and the paper is tile 0
+ */
+#define TTE_GLYPH_SE(c, pb) ((SE)(((c) - ' ') | SE_PALBANK(pb)))
+#define TTE_BLANK_SE 0
+
 // When making this, missed that it already exists in tonc_math.h
 typedef RECT Rect;
 
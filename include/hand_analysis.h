@@ -3,14 +3,102 @@
 
 #include <tonc.h>
 #include "card.h"
+#include "game.h"
+#include "util.h"
 
-void get_hand_distribution(u8 *ranks_out, u8 *suits_out);
-void get_played_distribution(u8 *ranks_out, u8 *suits_out);
+#define RANK_COUNT_BITS 4 // Bits per rank lane in HandDistribution.rank_counts
+#define RANK_COUNTS_PER_WORD 8
+#define SUIT_COUNT_BITS 8 // Bits per suit lane in HandDistribution.suit_counts
 
-u8 hand_contains_n_of_a_kind(u8 *ranks);
-bool hand_contains_two_pair(u8 *ranks);
-bool hand_contains_full_house(u8 *ranks);
-bool hand_contains_straight(u8 *ranks);
-bool hand_contains_flush(u8 *suits);
+/* Bitwise summary of a set of cards, used to classify hands without scanning histograms.
+ *
+ * rank_counts packs the number of cards of each rank in 4-bit lanes,
+ * ranks TWO to NINE in the first word and TEN to ACE in the second.
+ * This lets the N-of-a-kind checks test all the ranks of a word at once.
+ * Lanes are only guaranteed to be correct up to 8 cards of the same rank,
+ * which is plenty for a standard deck.
+ *
+ * rank_mask has bit n set if at least one card of rank n is present, for straights.
+ * suit_counts packs the number of cards of each suit in 8-bit lanes.
+ */
+typedef struct
+{
+    u32 rank_counts[2];
+    u32 suit_counts;
+    u16 rank_mask;
+} HandDistribution;
 
-#endif
\ No newline at end of file
+INLINE void hand_distribution_clear(HandDistribution *dist)
+{
+    dist->rank_counts[0] = 0;
+    dist->rank_counts[1] = 0;
+    dist->suit_counts = 0;
+    dist->rank_mask = 0;
+}
+
+INLINE void hand_distribution_add_card(HandDistribution *dist, const Card *card)
+{
+    dist->rank_counts[card->rank / RANK_COUNTS_PER_WORD] += 1 << ((card->rank % RANK_COUNTS_PER_WORD) * RANK_COUNT_BITS);
+    dist->suit_counts += 1 << (card->suit * SUIT_COUNT_BITS);
+    dist->rank_mask |= 1 << card->rank;
+}
+
+INLINE u8 hand_distribution_get_rank_count(const HandDistribution *dist, u8 rank)
+{
+    return (dist->rank_counts[rank / RANK_COUNTS_PER_WORD] >> ((rank % RANK_COUNTS_PER_WORD) * RANK_COUNT_BITS)) & 0xF;
+}
+
+INLINE u8 hand_distribution_get_suit_count(const HandDistribution *dist, u8 suit)
+{
+    return (dist->suit_counts >> (suit * SUIT_COUNT_BITS)) & 0xFF;
+}
+
+// The card must have been added before. The rank stays in rank_mask while other cards of it are left
+INLINE void hand_distribution_remove_card(HandDistribution *dist, const Card *card)
+{
+    dist->rank_counts[card->rank / RANK_COUNTS_PER_WORD] -= 1 << ((card->rank % RANK_COUNTS_PER_WORD) * RANK_COUNT_BITS);
+    dist->suit_counts -= 1 << (card->suit * SUIT_COUNT_BITS);
+    if (hand_distribution_get_rank_count(dist, card->rank) == 0)
+        dist->rank_mask &= ~(1 << card->rank);
+}
+
+// Everything the jokers need to know about the played hand.
+// Computed once when the hand starts scoring instead of by every joker that needs it.
+typedef struct
+{
+    HandDistribution distribution; // Of the scoring cards only
+    enum HandType hand_type;
+    u8 played_count; // All the played cards, scoring or not
+    u8 scoring_count;
+    u8 face_count; // Scoring cards considered face cards, so this accounts for Pareidolia
+    u8 held_count;
+    Card *held_cards[MAX_HAND_SIZE]; // Cards held in hand while the played hand is scored
+    int money; // The player's money when the hand started scoring
+    int money_earned; // Earned by the jokers so far while scoring, kept up to date by score_hand()
+} HandContext;
+
+// The player's money as it would be at this point of the scoring
+INLINE int hand_context_get_money(const HandContext *context)
+{
+    return context->money + context->money_earned;
+}
+
+void get_hand_distribution(HandDistribution *dist_out);
+void get_played_hand_context(HandContext *context_out, enum HandType hand_type);
+void hand_context_make(HandContext *context_out, enum HandType hand_type, int num_played_cards, Card *scoring_cards[], int num_scoring_cards,
+                       Card *held_cards[], int num_held_cards);
+
+// Flags which of the played cards score for the given hand type, e.g. only the pair of a PAIR.
+// cards are in played order.
+void hand_get_scoring_cards(Card *cards[], int num_cards, enum HandType hand_type, bool is_scoring_out[]);
+
+ARM_IWRAM_CODE u8 hand_contains_n_of_a_kind(const HandDistribution *dist);
+ARM_IWRAM_CODE bool hand_contains_two_pair(const HandDistribution *dist);
+ARM_IWRAM_CODE bool hand_contains_full_house(const HandDistribution *dist);
+ARM_IWRAM_CODE bool hand_contains_straight(const HandDistribution *dist);
+ARM_IWRAM_CODE bool hand_contains_royal(const HandDistribution *dist); // Contains every rank from TEN to ACE
+ARM_IWRAM_CODE bool hand_contains_flush(const HandDistribution *dist);
+
+ARM_IWRAM_CODE enum HandType hand_distribution_get_type(const HandDistribution *dist);
+
+#endif
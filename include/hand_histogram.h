@@ -0,0 +1,123 @@
+#ifndef HAND_HISTOGRAM_H
+#define HAND_HISTOGRAM_H
+
+#include <tonc.h>
+#include "card.h"
+#include "game.h"
+
+/* The hand classifier from before HandDistribution, on plain per-rank and per-suit counts.
+ * The game doesn't use it. It's kept as the reference hand_distribution_get_type() is
+ * checked against (host/test/hand_analysis_test.c) and timed against (the bench ROM).
+ */
+
+INLINE void hand_histogram_add_card(u8 ranks[NUM_RANKS], u8 suits[NUM_SUITS], const Card *card)
+{
+    ranks[card->rank]++;
+    suits[card->suit]++;
+}
+
+// Returns the highest N of a kind. So a full-house would return 3.
+INLINE u8 hand_histogram_n_of_a_kind(const u8 ranks[NUM_RANKS])
+{
+    u8 highest_n = 0;
+    for (int i = 0; i < NUM_RANKS; i++)
+    {
+        if (ranks[i] > highest_n)
+            highest_n = ranks[i];
+    }
+    return highest_n;
+}
+
+INLINE bool hand_histogram_two_pair(const u8 ranks[NUM_RANKS])
+{
+    bool contains_other_pair = false;
+    for (int i = 0; i < NUM_RANKS; i++)
+    {
+        if (ranks[i] >= 2)
+        {
+            if (contains_other_pair)
+                return true;
+            contains_other_pair = true;
+        }
+    }
+    return false;
+}
+
+INLINE bool hand_histogram_full_house(const u8 ranks[NUM_RANKS])
+{
+    int count_three = 0;
+    int count_pair = 0;
+    for (int i = 0; i < NUM_RANKS; i++)
+    {
+        if (ranks[i] >= 3)
+            count_three++;
+        else if (ranks[i] >= 2)
+            count_pair++;
+    }
+    return count_three >= 2 || (count_three && count_pair);
+}
+
+INLINE bool hand_histogram_straight(const u8 ranks[NUM_RANKS])
+{
+    for (int i = 0; i < NUM_RANKS - 4; i++)
+    {
+        if (ranks[i] && ranks[i + 1] && ranks[i + 2] && ranks[i + 3] && ranks[i + 4])
+            return true;
+    }
+    // Check for ace low straight
+    return ranks[ACE] && ranks[TWO] && ranks[THREE] && ranks[FOUR] && ranks[FIVE];
+}
+
+INLINE bool hand_histogram_royal(const u8 ranks[NUM_RANKS])
+{
+    return ranks[TEN] && ranks[JACK] && ranks[QUEEN] && ranks[KING] && ranks[ACE];
+}
+
+INLINE bool hand_histogram_flush(const u8 suits[NUM_SUITS])
+{
+    for (int i = 0; i < NUM_SUITS; i++)
+    {
+        if (suits[i] >= MAX_SELECTION_SIZE) // this allows MAX_SELECTION_SIZE - 1 for four fingers joker
+            return true;
+    }
+    return false;
+}
+
+// Same decision order as hand_distribution_get_type(), the counts are expected to hold at least one card
+INLINE enum HandType hand_histogram_get_type(const u8 ranks[NUM_RANKS], const u8 suits[NUM_SUITS])
+{
+    enum HandType res_hand_type = HIGH_CARD;
+
+    if (hand_histogram_flush(suits))
+        res_hand_type = FLUSH;
+
+    if (hand_histogram_straight(ranks))
+        res_hand_type = res_hand_type == FLUSH ? STRAIGHT_FLUSH : STRAIGHT;
+
+    if (res_hand_type == STRAIGHT_FLUSH)
+        return hand_histogram_royal(ranks) ? ROYAL_FLUSH : STRAIGHT_FLUSH;
+
+    u8 n_of_a_kind = hand_histogram_n_of_a_kind(ranks);
+
+    if (n_of_a_kind >= 5)
+        return res_hand_type == FLUSH ? FLUSH_FIVE : FIVE_OF_A_KIND;
+
+    if (n_of_a_kind == 4)
+        return FOUR_OF_A_KIND;
+
+    if (n_of_a_kind == 3 && hand_histogram_full_house(ranks))
+        return FULL_HOUSE;
+
+    if (res_hand_type == FLUSH)
+        return FLUSH;
+
+    if (n_of_a_kind == 3)
+        return THREE_OF_A_KIND;
+
+    if (n_of_a_kind == 2)
+        return hand_histogram_two_pair(ranks) ? TWO_PAIR : PAIR;
+
+    return res_hand_type;
+}
+
+#endif // HAND_HISTOGRAM_H
@@ -0,0 +1,50 @@
+#ifndef INPUT_TRACE_H
+#define INPUT_TRACE_H
+
+#include <tonc.h>
+
+/* Records the keys of every frame and the seeds passed to set_seed(), or plays them back,
+ * so the same run can be played on different builds to compare their frame times.
+ *
+ * `make RECORD=1` builds a ROM that writes the trace to the upper half of cartridge SRAM
+ * as it's played, so the emulator's .sav file holds the trace. `make REPLAY=1` builds one
+ * that reads the trace from there and feeds it to the game instead of the real keys.
+ * The recorded seeds replace the ones the game comes up with, a build that changed how the
+ * seed is picked still plays the same cards. When the trace runs out the replay logs how
+ * many frames it played to mGBA's log and stops the CPU with the Stop() BIOS call,
+ * which a headless `mgba-rom-test -S 3` exits on.
+ *
+ * Each trace entry is a u16, the key state in the low 10 bits and how many frames it was
+ * held for minus one in the high 6 bits.
+ *
+ * Without RECORD or REPLAY the macros are the plain calls and none of this is compiled.
+ */
+#define INPUT_TRACE_SRAM_OFFSET 0x4000 // The lower half is left for saves
+#define INPUT_TRACE_SRAM_SIZE   0x4000
+#define INPUT_TRACE_MAX_SEEDS   16
+
+#if defined(INPUT_RECORD) && defined(INPUT_REPLAY)
+#error "A build can either record or replay input, not both"
+#endif
+
+#if defined(INPUT_RECORD) || defined(INPUT_REPLAY)
+
+void input_trace_init(void);
+// Replaces key_poll()
+void input_trace_key_poll(void);
+// Returns the seed to use instead of seed
+u32 input_trace_seed(u32 seed);
+
+#define INPUT_TRACE_INIT() input_trace_init()
+#define INPUT_TRACE_KEY_POLL() input_trace_key_poll()
+#define INPUT_TRACE_SEED(seed) input_trace_seed(seed)
+
+#else
+
+#define INPUT_TRACE_INIT() ((void)0)
+#define INPUT_TRACE_KEY_POLL() key_poll()
+#define INPUT_TRACE_SEED(seed) (seed)
+
+#endif
+
+#endif // INPUT_TRACE_H
@@ -7,14 +7,9 @@
 #include "card.h"
 #include "game.h"
 #include "graphic_utils.h"
+#include "hand_analysis.h"
 
-#define JOKER_TID (MAX_HAND_SIZE + MAX_SELECTION_SIZE) * JOKER_SPRITE_OFFSET // Tile ID for the starting index in the tile memory
-#define JOKER_SPRITE_OFFSET 16 // Offset for the joker sprites
-#define JOKER_BASE_PB 4 // The starting palette index for the jokers
-#define JOKER_LAST_PB (NUM_PALETTES - 1) 
-// Currently allocating the rest of the palettes for the jokers.
-// This number needs to be decreased once we need to allocated palettes for other sprites
-// such as planet cards etc.
+#define JOKER_SPRITE_OFFSET 16 // Tiles per joker in the spritesheets
 
 #define JOKER_STARTING_LAYER 27
 
@@ -32,6 +27,7 @@
 #define LEGENDARY_JOKER 3
 
 #define MAX_JOKER_OBJECTS 32 // The maximum number of joker objects that can be created at once
+#define NUM_JOKERS 43 // Entries in the joker registry, the build fails if it's out of date
 
 #define DEFAULT_JOKER_ID 0
 #define GREEDY_JOKER_ID 1 // This is just an example to show the patern of making joker IDs
@@ -45,7 +41,6 @@ typedef struct
     u8 modifier; // base, foil, holo, poly, negative
     u8 value;
     u8 rarity;
-    bool processed;
 } Joker;
 
 typedef struct JokerObject
@@ -63,30 +58,76 @@ typedef struct  // These jokers are triggered after the played hand has finished
     bool retrigger; // Retrigger played hand (e.g. "Dusk" joker, even though on the wiki it says "On Scored" it makes more sense to have it here)
 } JokerEffect;
 
-typedef JokerEffect (*JokerEffectFunc)(Joker *joker, Card *scored_card);
+typedef JokerEffect (*JokerEffectFunc)(Joker *joker, Card *scored_card, const HandContext *hand_context);
+
+// The points of the round at which a joker's effect is called
+enum JokerPhase
+{
+    JOKER_PHASE_ON_SCORED,    // Once per scored card, scored_card is set
+    JOKER_PHASE_INDEPENDENT,  // Once for the whole hand after the cards, scored_card is NULL
+    JOKER_PHASE_HELD,         // Reads the cards held in hand. These are still scored once for the whole hand so they are also independent
+    JOKER_PHASE_END_OF_ROUND, // After the blind is beaten, none yet
+    JOKER_NUM_PHASES
+};
+
+#define JOKER_PHASE_FLAG(phase) (1 << (phase))
+#define JOKER_ON_SCORED JOKER_PHASE_FLAG(JOKER_PHASE_ON_SCORED)
+#define JOKER_INDEPENDENT JOKER_PHASE_FLAG(JOKER_PHASE_INDEPENDENT)
+#define JOKER_HELD JOKER_PHASE_FLAG(JOKER_PHASE_HELD)
+#define JOKER_END_OF_ROUND JOKER_PHASE_FLAG(JOKER_PHASE_END_OF_ROUND)
+#define JOKER_ALL_PHASES (JOKER_PHASE_FLAG(JOKER_NUM_PHASES) - 1) // For jokers that copy another joker
+// Not a phase: the effect only reads the game state, never the played or held cards, the money earned
+// while scoring or the RNG, so it's the same for every play of a hand.
+// The solver calls these once per hand instead of once per play.
+#define JOKER_PLAY_INVARIANT (1 << 7)
+
 typedef struct {
     u8 rarity;
     u8 base_value;
+    u8 phases; // JOKER_PHASE_FLAG() of every phase the effect can trigger in, plus JOKER_PLAY_INVARIANT
     JokerEffectFunc effect;
 } JokerInfo;
 const JokerInfo* get_joker_registry_entry(int joker_id);
 size_t get_joker_registry_size(void);
 
-void joker_init();
+typedef struct
+{
+    JokerEffectFunc effect;
+    Joker *joker;
+    s8 joker_idx; // Index in the held jokers
+    const JokerEffect *fixed_effect; // Scored instead of calling effect when set, see solver_start()
+} JokerDispatchEntry;
+
+/* The held jokers bucketed by phase so scoring only calls the effects that can trigger.
+ * Built from the held jokers with joker_dispatch_build(), it must be rebuilt whenever they change.
+ * Each bucket keeps the order of the held jokers.
+ */
+typedef struct JokerDispatch
+{
+    int num_jokers; // Number of held jokers, including the ones with no effect
+    int num_entries[JOKER_NUM_PHASES];
+    JokerDispatchEntry entries[JOKER_NUM_PHASES][MAX_JOKERS_HELD_SIZE];
+} JokerDispatch;
+
+void joker_dispatch_build(JokerDispatch *dispatch, Joker *jokers[], int num_jokers);
+
+const Pool *joker_get_pool(void);
+const Pool *joker_object_get_pool(void);
 
 Joker *joker_new(u8 id);
 void joker_destroy(Joker **joker);
 
 // Unique effects like "Four Fingers" or "Credit Card" will be hard coded into game.c with a conditional check for the joker ID from the players owned jokers
 // game.c should probably be restructured so most of the variables in it are moved to some sort of global variable header file so they can be easily accessed and modified for the jokers
-JokerEffect joker_get_score_effect(Joker *joker, Card *scored_card);
+JokerEffect joker_get_score_effect(Joker *joker, Card *scored_card, const HandContext *hand_context);
 int joker_get_sell_value(const Joker* joker);
 
+// Returns NULL if there is no pool slot, palette bank or tiles left for it, joker is then still the caller's
 JokerObject *joker_object_new(Joker *joker);
 void joker_object_destroy(JokerObject **joker_object);
 void joker_object_update(JokerObject *joker_object);
 void joker_object_shake(JokerObject *joker_object, mm_word sound_id); // This doesn't actually score anything, it just performs an animation and plays a sound effect
-bool joker_object_score(JokerObject *joker_object, Card* scored_card, int *chips, int *mult, int *xmult, int *money, bool *retrigger); // This scores the joker and returns true if it was scored successfully (Card = NULL means the joker is independent and not scored by a card)
+void joker_object_show_effect(JokerObject *joker_object, const JokerEffect *joker_effect); // Displays the joker's score and shakes it, the scoring itself is done by score_hand()
 
 void joker_object_set_selected(JokerObject* joker_object, bool selected);
 bool joker_object_is_selected(JokerObject* joker_object);
@@ -1,27 +1,67 @@
-#ifndef LIST_H
-#define LIST_H
-
-#include <stdbool.h>
-
-typedef struct List
-{
-    void** _array;
-    int size;
-    int allocated_size;
-} List;
-
-List *list_new(int init_size);
-void list_destroy(List **list);
-bool list_append(List *list, void *value);
-bool list_remove_by_idx(List *list, int index);
-void* list_get(List *list, int index);
-int list_get_size(List *list);
-bool list_remove_by_value(List *list, void *value);
-bool list_exists(List *list, void *value);
-
-bool int_list_append(List *list, intptr_t value);
-intptr_t int_list_get(List *list, int index);
-bool int_list_remove_by_value(List *list, intptr_t value);
-bool int_list_exists(List *list, intptr_t value);
-
-#endif
+#ifndef LIST_H
+#define LIST_H
+
+#include <stdbool.h>
+
+#include "util.h"
+
+/* Fixed capacity arrays of one element type, used instead of growing arrays on the heap.
+ * LIST_DEFINE(type, ListType, prefix, capacity) declares the struct ListType holding up to capacity
+ * elements of type, along with these functions on it:
+ *
+ *  prefix_clear(list)                  empties it, lists in static storage start out empty
+ *  prefix_size(list)
+ *  prefix_get(list, idx)               idx has to be below the size, it isn't checked
+ *  prefix_append(list, value)          false if the list is full
+ *  prefix_remove(list, idx)            shifts the elements after idx down, keeps the order
+ *  prefix_swap_remove(list, idx)       moves the last element into idx, O(1) where the order doesn't matter
+ *  prefix_find(list, value)            the index of the first element equal to value, or UNDEFINED
+ *
+ * The elements are list->items[0] to list->items[list->size - 1], loops can also go over them directly.
+ */
+#define LIST_DEFINE(type, ListType, prefix, capacity)                           \
+    typedef struct ListType                                                     \
+    {                                                                           \
+        int size;                                                               \
+        type items[capacity];                                                   \
+    } ListType;                                                                 \
+    static inline void prefix##_clear(ListType *list)                           \
+    {                                                                           \
+        list->size = 0;                                                         \
+    }                                                                           \
+    static inline int prefix##_size(const ListType *list)                       \
+    {                                                                           \
+        return list->size;                                                      \
+    }                                                                           \
+    static inline type prefix##_get(const ListType *list, int idx)              \
+    {                                                                           \
+        return list->items[idx];                                                \
+    }                                                                           \
+    static inline bool prefix##_append(ListType *list, type value)              \
+    {                                                                           \
+        if (list->size >= (capacity))                                           \
+            return false;                                                       \
+        list->items[list->size++] = value;                                      \
+        return true;                                                            \
+    }                                                                           \
+    static inline void prefix##_remove(ListType *list, int idx)                 \
+    {                                                                           \
+        list->size--;                                                           \
+        for (int i = idx; i < list->size; i++)                                  \
+            list->items[i] = list->items[i + 1];                                \
+    }                                                                           \
+    static inline void prefix##_swap_remove(ListType *list, int idx)            \
+    {                                                                           \
+        list->items[idx] = list->items[--list->size];                           \
+    }                                                                           \
+    static inline int prefix##_find(const ListType *list, type value)           \
+    {                                                                           \
+        for (int i = 0; i < list->size; i++)                                    \
+        {                                                                       \
+            if (list->items[i] == value)                                        \
+                return i;                                                       \
+        }                                                                       \
+        return UNDEFINED;                                                       \
+    }
+
+#endif // LIST_H
@@ -0,0 +1,35 @@
+#ifndef MGBA_LOG_H
+#define MGBA_LOG_H
+
+#include <tonc.h>
+
+/* Lines printed to mGBA's log through its debug registers, for the development builds.
+ * Real hardware and other emulators don't have the registers, there mgba_log_init()
+ * returns false and the lines go nowhere.
+ */
+
+// Only the builds that log have it, so release ROMs don't link vsnprintf()
+#if defined(PROFILE) || defined(INPUT_RECORD) || defined(INPUT_REPLAY) || defined(BENCH) || defined(POOL_DEBUG)
+#define MGBA_LOG
+#endif
+
+#ifdef MGBA_LOG
+
+#define MGBA_LOG_MAX_LEN 0x100 // Including the terminator, longer lines are cut
+
+enum MgbaLogLevel
+{
+    MGBA_LOG_FATAL,
+    MGBA_LOG_ERROR,
+    MGBA_LOG_WARN,
+    MGBA_LOG_INFO,
+    MGBA_LOG_DEBUG
+};
+
+// Returns whether the log is there
+bool mgba_log_init(void);
+void mgba_logf(enum MgbaLogLevel level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+#endif // MGBA_LOG
+
+#endif // MGBA_LOG_H
@@ -0,0 +1,38 @@
+#ifndef PAL_BANK_H
+#define PAL_BANK_H
+
+#include <tonc.h>
+
+/* Hands out the OBJ palette banks to the sprites by the palette they show,
+ * the same way the tile cache hands out OBJ tiles.
+ * Palettes with the same colors share a bank even when they are different arrays.
+ * Banks are refcounted. A bank nobody uses keeps its colors until it is needed for another palette,
+ * the one released the longest ago is evicted first.
+ *
+ * BG palette banks aren't handed out, the backgrounds are 8bpp and take up the start of
+ * BG palette memory, the affine background and TTE have fixed banks after them.
+ */
+
+// Empties all banks, called by sprite_init()
+void pal_bank_init(void);
+
+typedef struct
+{
+    int hits;      // Acquired palettes that were already in a bank
+    int misses;    // Acquired palettes that had to be copied
+    int evictions; // Misses that overwrote the colors of another palette
+    int failures;  // Acquires with every bank in use
+} PalBankStats;
+
+/* Returns the palette bank holding the PAL_ROW_LEN colors of palette, copying them to one if none does.
+ * palette must stay valid while it's in a bank, so ROM or static data.
+ * Returns UNDEFINED if every bank is in use.
+ */
+int pal_bank_acquire(const u16 *palette);
+
+// Gives back a use of the bank pb, its colors stay until the bank is needed
+void pal_bank_release(int pb);
+
+const PalBankStats *pal_bank_get_stats(void);
+
+#endif // PAL_BANK_H
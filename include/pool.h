@@ -0,0 +1,73 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <tonc.h>
+
+/* Fixed capacity pools of same sized objects, used instead of malloc()/free()
+ * for the objects that are created and destroyed while playing.
+ * Allocating and freeing are O(1) and never fragment: slots that were never used are handed out in order,
+ * freed slots are pushed on a stack of free indices and reused first.
+ * The number of slots ever handed out is also the high water mark, for tuning the capacities.
+ *
+ * Building with POOL_DEBUG defined (the host build does, `make POOL_DEBUG=1` for the ROM) tracks which slots are in use
+ * and aborts on a double free, on freeing a pointer from outside the pool and when the pool runs out.
+ * The ROM prints the error to mGBA's log and halts.
+ * Leaks can be found by checking pool_get_num_in_use() where every object should have been freed.
+ */
+typedef struct
+{
+    const char *name;
+    u8 *storage;
+    u16 *free_indices;
+    u32 *in_use_bits; // Only kept up to date with POOL_DEBUG
+    u16 elem_size;
+    u16 capacity;
+    u16 num_used; // Slots ever handed out, they are never given back to the untouched region
+    u16 num_free; // Slots on the free stack
+} Pool;
+
+void *pool_alloc(Pool *pool);
+// Frees the slot at idx, use the typed name_free() from POOL_DEFINE() to free by pointer
+void pool_free_idx(Pool *pool, int idx);
+
+static inline int pool_get_num_in_use(const Pool *pool)
+{
+    return pool->num_used - pool->num_free;
+}
+
+static inline int pool_get_high_water(const Pool *pool)
+{
+    return pool->num_used;
+}
+
+static inline int pool_get_capacity(const Pool *pool)
+{
+    return pool->capacity;
+}
+
+/* Defines a static pool of capacity objects of type in EWRAM,
+ * along with name_alloc() and name_free() that take and return type pointers.
+ * Objects are not cleared when allocated, the same as malloc().
+ */
+#define POOL_DEFINE(type, name, capacity)                                       \
+    static EWRAM_BSS type name##_storage[capacity];                             \
+    static EWRAM_BSS u16 name##_free_indices[capacity];                         \
+    static u32 name##_in_use_bits[((capacity) + 31) / 32];                      \
+    static Pool name =                                                          \
+    {                                                                           \
+        #name, (u8 *)name##_storage, name##_free_indices, name##_in_use_bits,   \
+        sizeof(type), (capacity), 0, 0                                          \
+    };                                                                          \
+    static inline type *name##_alloc(void)                                      \
+    {                                                                           \
+        return (type *)pool_alloc(&name);                                       \
+    }                                                                           \
+    static inline void name##_free(type *elem)                                  \
+    {                                                                           \
+        /* The pointer difference divides by a constant, no call to the */      \
+        /* software divide on the GBA */                                        \
+        if (elem != NULL)                                                       \
+            pool_free_idx(&name, elem - name##_storage);                        \
+    }
+
+#endif // POOL_H
@@ -0,0 +1,69 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <tonc.h>
+
+/* Frame profiler for builds made with `make PROFILE=1`.
+ * Times come from the TM2/TM3 cycle counter, see cycle_counter.h.
+ * PROFILE_BEGIN()/PROFILE_END() add the cycles between them to a zone, zones can nest
+ * and each one counts everything inside it. PROFILE_FRAME() closes the frame and keeps
+ * the last PROFILE_HISTORY_LEN frames of every zone for their min/avg/max.
+ *
+ * Holding B and pressing START toggles an overlay on the TTE layer with each zone's
+ * average and max as a percentage of the frame. The same figures are logged to
+ * mGBA's debug log every PROFILE_REPORT_PERIOD frames.
+ *
+ * Without PROFILE the macros are empty and none of this is compiled.
+ */
+#define PROFILE_HISTORY_LEN 64
+#define PROFILE_REPORT_PERIOD 60
+#define PROFILE_FRAME_CYCLES 280896 // 228 scanlines of 1232 cycles
+
+enum ProfileZone
+{
+    PROFILE_ZONE_VBLANK,      // The VBlank uploads at the top of the frame
+    PROFILE_ZONE_AUDIO,
+    PROFILE_ZONE_AFFINE_BG,
+    PROFILE_ZONE_GAME,        // All of game_update()
+    PROFILE_ZONE_JOKERS,
+    PROFILE_ZONE_CARDS,
+    PROFILE_ZONE_SPRITE_DRAW,
+    PROFILE_ZONE_SAVE,        // Writing a queued save to SRAM
+    PROFILE_ZONE_IDLE,        // The hint solver filling the rest of the frame
+    // game_update() of each GameState, in the same order as the enum
+    PROFILE_ZONE_SPLASH_SCREEN,
+    PROFILE_ZONE_MAIN_MENU,
+    PROFILE_ZONE_PLAYING,
+    PROFILE_ZONE_ROUND_END,
+    PROFILE_ZONE_SHOP,
+    PROFILE_ZONE_BLIND_SELECT,
+    PROFILE_ZONE_LOSE,
+    PROFILE_ZONE_WIN,
+    PROFILE_ZONE_COUNT
+};
+
+#define PROFILE_ZONE_GAME_STATE(game_state) (PROFILE_ZONE_SPLASH_SCREEN + (game_state))
+
+#ifdef PROFILE
+
+void profiler_init(void);
+void profiler_begin(enum ProfileZone zone);
+void profiler_end(enum ProfileZone zone);
+// Call once a frame, after key_poll() so the overlay toggle sees this frame's keys
+void profiler_frame(void);
+
+#define PROFILE_INIT() profiler_init()
+#define PROFILE_BEGIN(zone) profiler_begin(zone)
+#define PROFILE_END(zone) profiler_end(zone)
+#define PROFILE_FRAME() profiler_frame()
+
+#else
+
+#define PROFILE_INIT() ((void)0)
+#define PROFILE_BEGIN(zone) ((void)(zone))
+#define PROFILE_END(zone) ((void)(zone))
+#define PROFILE_FRAME() ((void)0)
+
+#endif // PROFILE
+
+#endif // PROFILER_H
@@ -0,0 +1,42 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <tonc.h>
+
+/* Independent random number streams so that drawing from one subsystem
+ * doesn't change the outcome of another, e.g. a sound's random pitch
+ * must not change which jokers the shop offers.
+ * All the streams are derived from a single seed so a run can be reproduced.
+ */
+enum RngStream
+{
+    RNG_DECK,      // Deck shuffling
+    RNG_SHOP,      // Shop items
+    RNG_JOKER,     // Joker effects that roll during scoring
+    RNG_COSMETIC,  // Sound pitch and other effects with no gameplay impact
+    RNG_NUM_STREAMS
+};
+
+// Reseeds every stream from seed
+void rng_set_seed(u32 seed);
+
+// For looking ahead without consuming the stream: save its state, draw, then restore it
+u32 rng_get_state(enum RngStream stream);
+void rng_set_state(enum RngStream stream, u32 state);
+
+// Returns the next 32 random bits of the stream
+u32 rng_next(enum RngStream stream);
+
+/* Returns a random number in [0, n) using a multiply and shift instead of a modulo,
+ * the GBA has no hardware divide.
+ * n must be at most 65536, the bias this leaves is under n / 65536 which is negligible for our ranges.
+ */
+u32 rng_range(enum RngStream stream, u32 n);
+
+// Returns true one time out of two
+static inline bool rng_coin_flip(enum RngStream stream)
+{
+    return rng_next(stream) >> 31;
+}
+
+#endif // RNG_H
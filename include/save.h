@@ -0,0 +1,68 @@
+#ifndef SAVE_H
+#define SAVE_H
+
+#include <tonc.h>
+
+/* Keeps one save, an image of up to SAVE_MAX_SIZE bytes, in the lower half of cartridge SRAM.
+ * What's in the image is up to the caller, who gives its version and size to save_init().
+ * A save written with another version or size is ignored.
+ *
+ * SRAM is 8 bits wide and slow, so a save only writes the bytes that changed since the last one.
+ * These go into a journal after the full image, as records of changed bytes followed
+ * by a commit record with the checksum of the image they make. When the journal is full, or most
+ * of the image changed, the full image is written to the other of two slots instead and
+ * the journal is started over for it:
+ *
+ *  0x0000  slot 0, a 16 byte header and the image
+ *  0x1000  slot 1
+ *  0x2000  the journal, a header naming the slot it applies to, then the records
+ *
+ * Each slot has a checksum and a sequence number, the valid slot with the highest one
+ * and the journal records up to the last commit that matches its checksum are the save.
+ * Nothing is overwritten before what replaces it is complete, so turning the power off
+ * while saving loses at most the save that was being written.
+ *
+ * save_write() only queues the writes, save_update() writes SAVE_BYTES_PER_FRAME of them
+ * each frame. save_init() reads the save from SRAM once at startup, after that save_load()
+ * is a copy from RAM.
+ *
+ * Builds that record or replay input traces (see input_trace.h) never save or load,
+ * a replay has to start from the main menu just like the recording did.
+ */
+#define SAVE_SRAM_OFFSET 0x0000
+#define SAVE_SRAM_SIZE   0x4000 // The upper half is for input traces
+#define SAVE_SLOT_SIZE   0x1000
+#define SAVE_HEADER_SIZE 16
+#define SAVE_MAX_SIZE    (SAVE_SLOT_SIZE - SAVE_HEADER_SIZE)
+// About 2000 cycles of byte writes, a full image takes under 20 frames
+#define SAVE_BYTES_PER_FRAME 256
+
+typedef struct
+{
+    int journal_writes;  // Saves written as changed bytes
+    int snapshot_writes; // Saves written as the full image
+    int skipped_writes;  // Saves that didn't change anything
+    u32 bytes_written;   // To SRAM since startup
+} SaveStats;
+
+// Reads the latest save from SRAM, version and size are those of the caller's image.
+// Calling it again drops the writes still queued and reads SRAM over
+void save_init(u16 version, int size);
+
+bool save_exists(void);
+
+// Copies the save to image, returns false if there is none
+bool save_load(void *image);
+
+// Saves image, the bytes are written by the following save_update() calls
+void save_write(const void *image);
+
+// Deletes the save, for when the run it holds is over
+void save_erase(void);
+
+// Writes what's queued, up to SAVE_BYTES_PER_FRAME, call once a frame
+void save_update(void);
+
+const SaveStats *save_get_stats(void);
+
+#endif // SAVE_H
@@ -0,0 +1,50 @@
+#ifndef SCORING_H
+#define SCORING_H
+
+#include "card.h"
+#include "joker.h"
+#include "util.h"
+#include "hand_analysis.h"
+
+// One event per scored card, plus at most one per joker for each scored card and once more for the whole hand
+#define MAX_SCORING_EVENTS (MAX_SELECTION_SIZE * (MAX_JOKERS_HELD_SIZE + 1) + MAX_JOKERS_HELD_SIZE)
+
+enum ScoringEventType
+{
+    SCORING_EVENT_CARD,  // A scoring card adds its value to the chips
+    SCORING_EVENT_JOKER, // A joker triggered, either on a scoring card or for the whole hand
+};
+
+typedef struct
+{
+    enum ScoringEventType type;
+    s8 card_idx;  // Index in the scoring cards, UNDEFINED for jokers scoring the whole hand
+    s8 joker_idx; // Index in the jokers, UNDEFINED for card events
+    JokerEffect effect; // What this event adds. For card events only the chips are set
+    int chips; // Running totals after this event
+    int mult;
+} ScoringEvent;
+
+typedef struct ScoreResult
+{
+    int chips;
+    int mult;
+    int money; // Money earned while scoring, not the player's total
+    int num_events;
+    ScoringEvent events[MAX_SCORING_EVENTS];
+} ScoreResult;
+
+/* Scores a played hand without touching the display, sprites or sound.
+ * scoring_cards are the played cards that score, in scoring order.
+ * The held cards and the hand type come from hand_context.
+ * Its money_earned follows result_out's money so jokers see what was earned before them.
+ * Only the jokers in the matching phase buckets of jokers are called.
+ * base_chips and base_mult are the hand type's values the score starts from.
+ * The result holds the final chips/mult/money and the ordered list of events
+ * for the animation to replay.
+ * Events past MAX_SCORING_EVENTS are still applied to the totals but not recorded.
+ */
+ARM_IWRAM_CODE void score_hand(Card *scoring_cards[], int num_scoring_cards, HandContext *hand_context,
+                               const JokerDispatch *jokers, int base_chips, int base_mult, ScoreResult *result_out);
+
+#endif // SCORING_H
@@ -0,0 +1,63 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <tonc.h>
+#include "game.h"
+#include "card.h"
+#include "joker.h"
+#include "hand_analysis.h"
+#include "scoring.h"
+
+/* Finds the play from the hand that scores the most with the current jokers.
+ * Every combination of 1 to MAX_SELECTION_SIZE cards is scored with score_hand(),
+ * one at a time through solver_step() so the search can be spread over several frames.
+ * The hand and jokers are copied at solver_start(), so the solver must be restarted when they change.
+ *
+ * Consecutive combinations share most of their cards, so the distribution of the played cards
+ * is kept from one step to the next and only the cards that changed are added or removed.
+ * The jokers flagged JOKER_PLAY_INVARIANT are called once at solver_start() and their effect reused.
+ */
+typedef struct
+{
+    Card *hand[MAX_HAND_SIZE];
+    int hand_size;
+    JokerDispatch jokers;
+
+    u32 next_mask; // The next combination to evaluate, bit i set for hand[i]
+    int num_evaluated;
+    bool done;
+
+    u32 best_mask;
+    enum HandType best_hand_type;
+    int best_score;
+
+    u32 played_mask; // The play distribution is for
+    HandDistribution distribution; // Of all the played cards
+    u32 face_mask; // Bit i set if hand[i] counts as a face card
+    bool needs_held_cards; // Only filled in the context for the jokers that read them
+    JokerEffect fixed_effects[MAX_JOKERS_HELD_SIZE]; // Of the play invariant independent jokers
+
+    HandContext hand_context; // Scratch space, too big for the stack
+    ScoreResult score_result;
+} Solver;
+
+void solver_start(Solver *solver, Card *hand[], int hand_size, const JokerDispatch *jokers);
+
+// Evaluates the next play. Returns false once all of them have been evaluated.
+bool solver_step(Solver *solver);
+
+// Runs the search to completion
+void solver_solve(Solver *solver);
+
+static inline bool solver_is_done(const Solver *solver)
+{
+    return solver->done;
+}
+
+// Whether hand[card_idx] is part of the best play found so far
+static inline bool solver_best_play_contains(const Solver *solver, int card_idx)
+{
+    return (solver->best_mask >> card_idx) & 1;
+}
+
+#endif // SOLVER_H
@@ -4,8 +4,12 @@
 #include <tonc.h>
 #include <maxmod.h>
 
+#include "pool.h"
+
 #define CARD_SPRITE_SIZE 32
 
+#define MAX_SPRITE_OBJECTS 64 // Every card and joker object has one
+
 typedef struct 
 {
     OBJ_ATTR *obj;
@@ -28,30 +32,58 @@ typedef struct
     FIXED vrotation;
     bool selected;
     bool focused;
-    
+    bool asleep; // Settled on its targets, sprite_object_update() skips it until something moves it
+    FIXED rest_x, rest_y, rest_scale, rest_rotation; // Where it fell asleep, to notice direct writes
 } SpriteObject;
 
 // Sprite methods
+/* The sprite takes over the use of the tiles at tid acquired from the tile cache
+ * and of the palette bank pb acquired from pal_bank_acquire(), both are released with the sprite
+ */
 Sprite *sprite_new(u16 a0, u16 a1, u32 tid, u32 pb, int sprite_index);
 Sprite *affine_sprite_new(u16 a0, u16 a1, u32 tid, u32 pb);
 void sprite_destroy(Sprite **sprite);
 int sprite_get_layer(Sprite *sprite);
+/* Has sprite_draw() send the sprite's OAM entry and affine matrix to OAM again.
+ * Only marked sprites are compared with what's in OAM, so call this after changing sprite->obj
+ * or sprite->aff directly. The functions below call it for you.
+ */
+void sprite_mark_dirty(const Sprite *sprite);
 INLINE void sprite_position(Sprite *sprite, int x, int y)
 {
     sprite->pos.x = x;
     sprite->pos.y = y;
 
     obj_set_pos(sprite->obj, x, y);
+    sprite_mark_dirty(sprite);
+}
+
+INLINE void sprite_hide(Sprite *sprite)
+{
+    obj_hide(sprite->obj);
+    sprite_mark_dirty(sprite);
+}
+
+INLINE void sprite_unhide(Sprite *sprite, u16 mode)
+{
+    obj_unhide(sprite->obj, mode);
+    sprite_mark_dirty(sprite);
 }
 
 // Sprite functions
 void sprite_init();
 void sprite_draw();
+/* Draws sprites[0] on top of sprites[1] and so on, all in front of the other sprites of the layers
+ * [first_layer, first_layer + num_layers). Only the OAM entries built by sprite_draw() change,
+ * the sprites keep their layers and tiles.
+ */
+void sprite_range_set_order(int first_layer, int num_layers, Sprite *sprites[], int num_sprites);
 int sprite_get_pb(const Sprite* sprite);
 
 // SpriteObject methods
 SpriteObject *sprite_object_new();
 void sprite_object_destroy(SpriteObject **sprite_object);
+const Pool *sprite_object_get_pool(void);
 void sprite_object_set_sprite(SpriteObject* sprite_object, Sprite* sprite);
 void sprite_object_reset_transform(SpriteObject* sprite_object);
 void sprite_object_update(SpriteObject *sprite_object);
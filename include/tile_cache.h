@@ -0,0 +1,49 @@
+#ifndef TILE_CACHE_H
+#define TILE_CACHE_H
+
+#include <tonc.h>
+
+/* Hands out OBJ tile memory to the sprites by what they show instead of by layer,
+ * so sprites showing the same card or joker share one copy of its tiles
+ * and tiles that are shown again soon after are still there to be reused.
+ * OBJ tile memory is split in slots the size of a 32x32 4bpp sprite.
+ * Slots are refcounted. A slot nobody uses keeps its tiles until it is needed for something else,
+ * the one released the longest ago is evicted first.
+ */
+#define TILE_CACHE_SLOT_TILES 16 // A 32x32 4bpp sprite
+#define TILE_CACHE_NUM_SLOTS (1024 / TILE_CACHE_SLOT_TILES) // All of OBJ tile memory in the tiled video modes
+
+enum TileCacheKind
+{
+    TILE_CACHE_CARD,  // id is suit * NUM_RANKS + rank
+    TILE_CACHE_JOKER, // id is the joker ID
+    TILE_CACHE_BLIND, // id is the BlindType
+};
+
+#define TILE_CACHE_KEY(kind, id) ((u16)(((kind) << 8) | (id)))
+
+// Empties the cache, called by sprite_init()
+void tile_cache_init(void);
+
+typedef struct
+{
+    int hits;      // Acquired tiles that were already in OBJ tile memory
+    int misses;    // Acquired tiles that had to be copied
+    int evictions; // Misses that overwrote tiles cached for something else
+} TileCacheStats;
+
+/* Returns the tile index of the tiles for key, copying them from tiles if they aren't cached.
+ * tiles must hold TILE_CACHE_SLOT_TILES tiles.
+ * Returns UNDEFINED if every slot is in use.
+ */
+int tile_cache_acquire(u16 key, const u32 *tiles);
+
+// Gives back a use of the tiles at tile_index, they stay cached until their slot is needed
+void tile_cache_release(int tile_index);
+
+// Copies new tiles over the cached tiles of key, for everything showing key to change
+void tile_cache_update(u16 key, const u32 *tiles);
+
+const TileCacheStats *tile_cache_get_stats(void);
+
+#endif // TILE_CACHE_H
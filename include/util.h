@@ -39,6 +39,17 @@ static inline int get_digits_even(int n)
 
 #define INT_MAX_DIGITS 10 // strlen(str(INT_MAX)) = strlen("2147483647")
 
+// Places a hot function in IWRAM and compiles it as ARM code regardless of the -mthumb default.
+// IWRAM has a 32-bit bus with no wait states, so ARM code runs there at full speed.
+// Keep such functions leaf functions or mark their callees the same way, ROM is out of direct branch range.
+// They're never inlined, that would put their code back in the caller's section.
+// List them in iwram_hot.txt too, the build checks that each one ended up in IWRAM as ARM code.
+#if defined(__arm__)
+#define ARM_IWRAM_CODE __attribute__((section(".iwram"), long_call, target("arm"), noinline))
+#else
+#define ARM_IWRAM_CODE
+#endif
+
 int int_arr_max(int int_arr[], int size);
 
 #endif // UTIL_H
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef VRAM_QUEUE_H
+#define VRAM_QUEUE_H
+
+#include <tonc.h>
+
+/* Defers writes to video memory to the start of VBlank, where they can't tear the display.
+ * Game code queues copies and fills while it runs, vram_queue_flush() moves them with DMA3
+ * right after VBlankIntrWait(). Each flush moves at most VRAM_QUEUE_FRAME_BUDGET bytes,
+ * what doesn't fit is split and carried over to the next frame ahead of anything queued later,
+ * so the writes always land in the order they were queued.
+ *
+ * The source of a queued copy is read when the queue is flushed, not when the copy is queued.
+ * It must still hold the same data then, so copy from ROM, from video memory or from static data
+ * that isn't changed before the flush, never from the stack. Fills keep their value in the queue.
+ * Reading back video memory that has writes queued gives the old contents, which is why the
+ * screenblocks that the CPU reads and edits in place are still written directly.
+ */
+#define VRAM_QUEUE_MAX_ENTRIES 64
+// A 16KB background tileset with its palette and OAM in one frame, about half of VBlank with DMA from ROM
+#define VRAM_QUEUE_FRAME_BUDGET 0x5000
+
+typedef struct
+{
+    int depth;            // Entries waiting to be flushed
+    int max_depth;
+    u32 bytes_moved;      // Bytes written to video memory since startup
+    int last_flush_bytes; // Bytes written by the last vram_queue_flush()
+    int overflows;        // Flushes that ran out of budget and carried entries over
+    int forced_flushes;   // Times the queue was full or flushed with vram_queue_flush_now(), outside VBlank
+} VramQueueStats;
+
+void vram_queue_copy16(void *dst, const void *src, uint hwcount);
+void vram_queue_copy32(void *dst, const void *src, uint wcount);
+void vram_queue_fill16(void *dst, u16 hw, uint hwcount);
+void vram_queue_fill32(void *dst, u32 wd, uint wcount);
+
+// Queued version of GRIT_CPY(), copies all of the grit array name to dst
+#define VRAM_QUEUE_GRIT_CPY(dst, name) vram_queue_copy16(dst, name, name##Len / 2)
+
+// Moves the queued writes to video memory, call at the start of VBlank
+void vram_queue_flush(void);
+
+// Moves all queued writes right away, before writing somewhere they may still be headed directly
+void vram_queue_flush_now(void);
+
+const VramQueueStats *vram_queue_get_stats(void);
+
+#endif // VRAM_QUEUE_H
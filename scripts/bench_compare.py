@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+
+"""Compares the results of the benchmark ROM with a baseline.
+
+Reads the `bench,...` CSV lines from an mGBA log, see include/bench.h, e.g.
+
+    make bench
+    mgba-rom-test -S 3 build_bench/build_bench.gba > bench.log
+    python3 scripts/bench_compare.py bench.log
+
+and fails if a kernel's average cycles went up by more than the threshold.
+It also fails when the run logged an error or didn't finish, when a baseline kernel
+is missing from the run and when the run has a kernel the baseline doesn't.
+--update writes the results as the new baseline instead, only from a complete run.
+"""
+
+import argparse
+import csv
+import os
+import sys
+
+DEFAULT_BASELINE = os.path.join(os.path.dirname(__file__), "bench_baseline.csv")
+DEFAULT_THRESHOLD = 0.05
+FIELDS = ["kernel", "iterations", "avg_cycles", "min_cycles"]
+
+
+def read_log(path):
+    """Returns the results by kernel, the error lines and whether the run got to the end."""
+    results = {}
+    errors = []
+    done = False
+    with open(path, errors="replace") as f:
+        for line in f:
+            # Errors are logged as "bench: <what went wrong>"
+            start = line.find("bench: ")
+            if start >= 0:
+                errors.append(line[start:].strip())
+                continue
+
+            start = line.find("bench,")
+            if start < 0:
+                continue
+
+            fields = line[start:].strip().split(",")[1:]
+            if fields == ["done"]:
+                done = True
+                continue
+            if len(fields) != len(FIELDS) or fields[0] == "kernel":
+                continue
+
+            results[fields[0]] = dict(zip(FIELDS, fields))
+    return results, errors, done
+
+
+def read_baseline(path):
+    with open(path, newline="") as f:
+        rows = csv.DictReader(line for line in f if not line.startswith("#"))
+        return {row["kernel"]: row for row in rows}
+
+
+def write_baseline(path, results):
+    with open(path, "w", newline="") as f:
+        f.write("# Written by scripts/bench_compare.py --update, cycles as measured in mGBA\n")
+        writer = csv.DictWriter(f, FIELDS)
+        writer.writeheader()
+        for kernel in sorted(results):
+            writer.writerow(results[kernel])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("log", help="mGBA log of a benchmark ROM run")
+    parser.add_argument("--baseline", default=DEFAULT_BASELINE)
+    parser.add_argument("--threshold", type=float, default=DEFAULT_THRESHOLD,
+                        help="allowed increase of the average cycles, 0.05 is 5%%")
+    parser.add_argument("--update", action="store_true", help="write the results as the new baseline")
+    args = parser.parse_args()
+
+    results, errors, done = read_log(args.log)
+    for error in errors:
+        print(error)
+    if not results:
+        print(f"No benchmark results in {args.log}")
+        return 1
+    if errors or not done:
+        # Some kernels were skipped or the run was cut short, the results can't be compared or kept
+        print(f"The benchmark run in {args.log} " + ("logged errors" if errors else "didn't finish"))
+        return 1
+
+    if args.update:
+        write_baseline(args.baseline, results)
+        print(f"Wrote {len(results)} kernels to {args.baseline}")
+        return 0
+
+    baseline = read_baseline(args.baseline)
+    if not baseline:
+        print(f"{args.baseline} has no kernels, record one from an mGBA run with --update")
+        return 1
+
+    regressions = 0
+    new_kernels = 0
+    for kernel in sorted(results):
+        cycles = int(results[kernel]["avg_cycles"])
+        if kernel not in baseline:
+            print(f"{kernel:32} {cycles:10}              NEW")
+            new_kernels += 1
+            continue
+
+        base_cycles = int(baseline[kernel]["avg_cycles"])
+        change = (cycles - base_cycles) / base_cycles if base_cycles > 0 else 0.0
+        regressed = change > args.threshold
+        regressions += regressed
+        print(f"{kernel:32} {cycles:10} {change:+8.1%}" + ("  REGRESSION" if regressed else ""))
+
+    for kernel in sorted(set(baseline) - set(results)):
+        print(f"{kernel:32}    missing")
+        regressions += 1
+
+    if new_kernels:
+        print(f"{new_kernels} kernels aren't in {args.baseline}, add them with --update")
+    if regressions:
+        print(f"{regressions} kernels regressed or are missing, over {args.threshold:.0%} slower than {args.baseline}")
+    return 1 if regressions or new_kernels else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,181 @@
+# Reports how much IWRAM, EWRAM and ROM each module uses, from the linker map, and checks
+# the placement of the hot functions. Plain POSIX awk so it runs in the devkitARM image.
+#
+#   awk -f memory_report.awk -v iwram_budget=<bytes> iwram_hot.txt <readelf -sW output> <map file>
+#
+# iwram_hot.txt lists the functions that must be ARM code in IWRAM, the ELF's symbol table
+# gives their addresses. readelf prints the raw symbol values, where Thumb functions have the
+# lowest bit set (nm clears it, so it can't be used for this). The map's input sections are
+# summed per object file, or per library for archive members. Initialized data in IWRAM and
+# EWRAM is counted in ROM too, that's where it's copied from at startup.
+# Exits with 1 if IWRAM use is over iwram_budget or a hot function isn't where it should be.
+
+function hex(str,    i, n, c)
+{
+    n = 0
+    str = tolower(str)
+    sub(/^0x/, "", str)
+    for (i = 1; i <= length(str); i++)
+    {
+        c = index("0123456789abcdef", substr(str, i, 1))
+        if (c == 0)
+            break
+        n = n * 16 + c - 1
+    }
+    return n
+}
+
+function region(addr)
+{
+    if (addr >= IWRAM_START && addr < IWRAM_END) return "iwram"
+    if (addr >= EWRAM_START && addr < EWRAM_END) return "ewram"
+    if (addr >= ROM_START && addr < ROM_END) return "rom"
+    return ""
+}
+
+function module_name(path)
+{
+    if (path ~ /\.a\(/)
+        sub(/\(.*/, "", path)
+    else
+        sub(/\.o$/, "", path)
+    sub(/.*\//, "", path)
+    return path
+}
+
+function add_section(name, addr, size, path,    where, module)
+{
+    where = region(addr)
+    if (where == "" || size == 0)
+        return
+
+    module = module_name(path)
+    if (!(module in seen))
+    {
+        seen[module] = 1
+        modules[num_modules++] = module
+    }
+    used[module, where] += size
+    total[where] += size
+
+    # Initialized RAM contents are stored in ROM
+    if (where != "rom" && out_section !~ /bss/ && name !~ /bss/ && name != "COMMON")
+    {
+        used[module, "rom"] += size
+        total["rom"] += size
+    }
+}
+
+BEGIN {
+    IWRAM_START = hex("0x03000000"); IWRAM_END = hex("0x03008000")
+    EWRAM_START = hex("0x02000000"); EWRAM_END = hex("0x02040000")
+    ROM_START = hex("0x08000000");   ROM_END = hex("0x0A000000")
+    if (iwram_budget == "")
+        iwram_budget = IWRAM_END - IWRAM_START
+    file = 0
+}
+
+FNR == 1 { file++ }
+
+# iwram_hot.txt
+file == 1 {
+    sub(/#.*/, "")
+    if (NF > 0)
+        hot[num_hot++] = $1
+    next
+}
+
+# readelf -sW output: Num: Value Size Type Bind Vis Ndx Name
+file == 2 {
+    if (NF >= 8 && $4 == "FUNC")
+        symbol[$8] = hex($2)
+    next
+}
+
+# The map, from the section layout on
+file == 3 && !in_layout {
+    if ($0 ~ /^Linker script and memory map/)
+        in_layout = 1
+    next
+}
+
+file == 3 {
+    # Output section, the input sections that follow belong to it
+    if ($0 ~ /^\.[^ ]/)
+    {
+        out_section = $1
+        pending = ""
+        next
+    }
+
+    # Input section whose name was too long, the address, size and file are on the next line
+    if (pending != "" && NF == 3 && $1 ~ /^0x/)
+    {
+        add_section(pending, hex($1), hex($2), $3)
+        pending = ""
+        next
+    }
+    pending = ""
+
+    if ($0 ~ /^ [.A-Z]/ && $1 != "*fill*")
+    {
+        if (NF == 1)
+            pending = $1
+        else if (NF >= 4 && $2 ~ /^0x/ && $3 ~ /^0x/)
+            add_section($1, hex($2), hex($3), $4)
+    }
+}
+
+END {
+    # Biggest IWRAM users first, then by ROM
+    for (i = 1; i < num_modules; i++)
+    {
+        m = modules[i]
+        for (j = i - 1; j >= 0; j--)
+        {
+            n = modules[j]
+            if (used[n, "iwram"] > used[m, "iwram"] || (used[n, "iwram"] == used[m, "iwram"] && used[n, "rom"] >= used[m, "rom"]))
+                break
+            modules[j + 1] = n
+        }
+        modules[j + 1] = m
+    }
+
+    printf "%-28s %8s %8s %8s\n", "module", "iwram", "ewram", "rom"
+    for (i = 0; i < num_modules; i++)
+    {
+        m = modules[i]
+        printf "%-28s %8d %8d %8d\n", m, used[m, "iwram"], used[m, "ewram"], used[m, "rom"]
+    }
+    printf "%-28s %8d %8d %8d\n", "total", total["iwram"], total["ewram"], total["rom"]
+    printf "IWRAM: %d of %d bytes budgeted, %d left\n", total["iwram"], iwram_budget, iwram_budget - total["iwram"]
+
+    failed = 0
+    if (total["iwram"] > iwram_budget)
+    {
+        printf "error: IWRAM use is %d bytes over budget\n", total["iwram"] - iwram_budget
+        failed = 1
+    }
+
+    for (i = 0; i < num_hot; i++)
+    {
+        name = hot[i]
+        if (!(name in symbol))
+        {
+            printf "error: %s from iwram_hot.txt isn't in the ROM\n", name
+            failed = 1
+        }
+        else if (region(symbol[name] - symbol[name] % 2) != "iwram")
+        {
+            printf "error: %s isn't in IWRAM, tag it ARM_IWRAM_CODE\n", name
+            failed = 1
+        }
+        else if (symbol[name] % 2 == 1)
+        {
+            printf "error: %s is Thumb code, tag it ARM_IWRAM_CODE\n", name
+            failed = 1
+        }
+    }
+
+    exit failed
+}
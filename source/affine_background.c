@@ -2,13 +2,29 @@
 #include "affine_background_gfx.h"
 #include "affine_main_menu_background_gfx.h"
 
+#include "bg_assets.h"
 #include "graphic_utils.h"
+#include "util.h"
 
 #define ANIMATION_SPEED_DIVISOR 16
 
-BG_AFFINE bgaff_arr[SCREEN_HEIGHT + 1];
+#define BG_SCALE 128 // .8 fixed point zoom of the background
+#define BG_TEX_OFFSET (1000 * 1000)
 
-AFF_SRC_EX asx = {0};
+#define SIN_TABLE_SIZE 512 // A full turn, the same as tonc's sin_lut
+#define SIN_TABLE_SHIFT 7 // From a 16-bit angle to a table index
+#define COS_OFFSET (SIN_TABLE_SIZE / 4)
+#define LINE_ANGLE_STEP (1 << 8) // How much further along the wave each scanline is
+#define LINE_INDEX_STEP (LINE_ANGLE_STEP >> SIN_TABLE_SHIFT)
+
+// The per-scanline matrices. DMA0 streams one table to the affine registers
+// in HBlank while the other one is built for the next frame.
+// In EWRAM, they're 5KB and the wait states cost the DMA only a few cycles per line.
+static EWRAM_BSS BG_AFFINE bgaff_tables[2][SCREEN_HEIGHT + 1];
+static int front_table = 0;
+
+// sin_lut copied to IWRAM, the table build reads three entries per scanline and ROM is slow to read
+static s16 sin_table[SIN_TABLE_SIZE];
 
 enum AffineBackgroundID background = AFFINE_BG_MAIN_MENU;
 
@@ -16,75 +32,68 @@ static uint timer = 0;
 
 void affine_background_init()
 {   
+    memcpy16(sin_table, sin_lut, SIN_TABLE_SIZE);
     affine_background_update();
 
     REG_BG_AFFINE[AFFINE_BG_IDX] = bg_aff_default;
 }
 
-// Pre-computes the affine matrices values for each scanline 
-// and stores in bgaff_arr. 
-// This is to be done in VBLANK so the HBLANK code 
-// can just fetch the values quickly.
-IWRAM_CODE void affine_background_prep_bgaff_arr()
+/* Builds the matrices for each scanline. Line v is rotated by the angle of the animation plus a sine wave
+ * down the screen. The wave's angle goes up by the same LINE_ANGLE_STEP every line, so its table index
+ * just steps by LINE_INDEX_STEP. All the sines are read from sin_table, the same values lu_sin() and lu_cos() give.
+ * With the zoom and the rotation center fixed, this is bg_rotscale_ex() with everything constant folded.
+ */
+ARM_IWRAM_CODE static void affine_background_build_table(BG_AFFINE *table, uint frame)
 {
-    for (u16 vcount = 0; vcount < SCREEN_HEIGHT; vcount++)
+    const s32 time_angle = (s32)(frame << 8) / ANIMATION_SPEED_DIVISOR; // Slows the animation down
+    const s32 scr_x = SCREEN_WIDTH / 2; // Centers the rotation
+    s32 scr_y = -(SCREEN_HEIGHT / 2);
+    uint line_idx = (uint)time_angle >> SIN_TABLE_SHIFT;
+
+    for (int vcount = 0; vcount < SCREEN_HEIGHT; vcount++)
     {
-        const s32 timer_s32 = timer << 8;
-        const s32 vcount_s32 = vcount << 8;
-        const s16 vcount_s16 = vcount;
-        const s32 vcount_sine = lu_sin(vcount_s32 + timer_s32 / ANIMATION_SPEED_DIVISOR); // dividing the timer by 16 to make the animation slower
-        
-        asx.scr_x = (SCREEN_WIDTH / 2); // 128 on x and y is an offset used to center the rotation
-        asx.scr_y = vcount_s16 - (SCREEN_HEIGHT / 2); // scr_y must equal vcount otherwise the background will have no vertical difference
-        asx.tex_x = (1000 * 1000) + (vcount_sine);
-        asx.tex_y = (1000 * 1000);
-        asx.sx = 128;
-        asx.sy = 128;
-        asx.alpha = vcount_sine + (timer_s32 / ANIMATION_SPEED_DIVISOR);
-
-        bg_rotscale_ex(&bgaff_arr[vcount], &asx);
+        const s32 line_sine = sin_table[line_idx % SIN_TABLE_SIZE];
+        const uint alpha_idx = (uint)(line_sine + time_angle) >> SIN_TABLE_SHIFT;
+        const s32 sina = sin_table[alpha_idx % SIN_TABLE_SIZE];
+        const s32 cosa = sin_table[(alpha_idx + COS_OFFSET) % SIN_TABLE_SIZE];
+
+        const s32 pa = cosa * BG_SCALE >> 12;
+        const s32 pb = -sina * BG_SCALE >> 12;
+        const s32 pc = sina * BG_SCALE >> 12;
+        const s32 pd = cosa * BG_SCALE >> 12;
+
+        BG_AFFINE *bgaff = &table[vcount];
+        bgaff->pa = pa;
+        bgaff->pb = pb;
+        bgaff->pc = pc;
+        bgaff->pd = pd;
+        bgaff->dx = BG_TEX_OFFSET + line_sine - (pa * scr_x + pb * scr_y);
+        bgaff->dy = BG_TEX_OFFSET - (pc * scr_x + pd * scr_y);
+
+        line_idx += LINE_INDEX_STEP;
+        scr_y++;
     }
 
-    /* HBLANK occurs after the scanline so REG_VCOUNT represents the 
-     * the scanline that just passed, so when it's SCREEN_HEIGHT we will
-     * actually be updating the first line
+    /* HBlank comes after the scanline, so the transfer in the HBlank of line SCREEN_HEIGHT - 1 
+     * reads past the last line, make it the first line again
      */
-    bgaff_arr[SCREEN_HEIGHT] = bgaff_arr[0];
+    table[SCREEN_HEIGHT] = table[0];
 }
 
-IWRAM_CODE void affine_background_hblank()
+void affine_background_vblank()
 {
-    vu16 vcount = REG_VCOUNT;
+    REG_DMA0CNT = 0; // Stop last frame's transfers, they would go on from the end of the table
 
-    if ((vcount >= SCREEN_HEIGHT)) // Exit the function if the scanline is outside the screen
-    {
-        return;
-    }
-
-    // See comment in affine_background_prep_bgaff_arr()
-    REG_BG_AFFINE[AFFINE_BG_IDX] = bgaff_arr[vcount + 1];
+    // The table built during the last frame is shown from now on, line 0 directly and the rest by HBlank DMA
+    front_table ^= 1;
+    BG_AFFINE *table = bgaff_tables[front_table];
+    REG_BG_AFFINE[AFFINE_BG_IDX] = table[0];
+    dma_cpy(&REG_BG_AFFINE[AFFINE_BG_IDX], &table[1], sizeof(BG_AFFINE) / 4, 0, DMA_HDMA | DMA_32);
 }
 
 void affine_background_update()
 {
-    if (REG_IE & IRQ_HBLANK) // High quality mode with HBLANK interrupt
-    {
-        affine_background_prep_bgaff_arr();
-    }
-    else // Low quality mode without HBLANK interrupt
-    {
-        asx.scr_x = 0;
-        asx.scr_y = 0;
-        asx.tex_x += 5;
-        asx.tex_y += 12;
-        asx.sx = ((lu_sin(timer * 100)) >> 8) + 256; // Scale the sine value to fit in a s16
-        asx.sy = ((lu_sin(timer * 100 + 0x4000)) >> 8) + 256; // Scale the sine value to fit in a s16
-        asx.alpha = 0;
-
-        bg_rotscale_ex(&bgaff_arr[0], &asx);
-        REG_BG_AFFINE[AFFINE_BG_IDX] = bgaff_arr[0];
-    }
-
+    affine_background_build_table(bgaff_tables[front_table ^ 1], timer);
     timer++;
 }
 
@@ -102,6 +111,12 @@ void affine_background_load_palette(const u16 *src)
     memcpy16(&pal_bg_mem[AFFINE_BG_PB], src, AFFINE_BG_PAL_LEN);
 }
 
+// Affine maps have a byte per tile, the tile offset of the asset is added to both bytes of each halfword
+static void affine_background_load_map(const unsigned short *map, uint map_len, enum BgAssetID asset)
+{
+    memcpy16_tile8_with_palette_offset(se_mem[AFFINE_BG_SBB], map, map_len / 2, bg_assets_get_first_tile(asset));
+}
+
 void affine_background_change_background(enum AffineBackgroundID new_bg)
 {
     background = new_bg;
@@ -111,19 +126,17 @@ void affine_background_change_background(enum AffineBackgroundID new_bg)
     case AFFINE_BG_MAIN_MENU:
         REG_BG2CNT &= ~BG_AFF_32x32;
         REG_BG2CNT |= BG_AFF_16x16;
-        REG_IE |= IRQ_HBLANK; // Enable HBLANK
 
-        memcpy32_tile8_with_palette_offset((u32*)&tile8_mem[AFFINE_BG_CBB], (const u32*)affine_main_menu_background_gfxTiles, affine_main_menu_background_gfxTilesLen/4, AFFINE_BG_PB);
-        GRIT_CPY(&se_mem[AFFINE_BG_SBB], affine_main_menu_background_gfxMap);
+        bg_assets_show(BG_ASSET_AFFINE_MAIN_MENU);
+        affine_background_load_map(affine_main_menu_background_gfxMap, affine_main_menu_background_gfxMapLen, BG_ASSET_AFFINE_MAIN_MENU);
         affine_background_load_palette(affine_main_menu_background_gfxPal);
         break;
     case AFFINE_BG_GAME:
         REG_BG2CNT &= ~BG_AFF_16x16;
         REG_BG2CNT |= BG_AFF_32x32;
-        REG_IE &= ~IRQ_HBLANK; // Disable HBLANK
 
-        memcpy32_tile8_with_palette_offset((u32*)&tile8_mem[AFFINE_BG_CBB], (const u32*)affine_background_gfxTiles, affine_background_gfxTilesLen/4, AFFINE_BG_PB);
-        GRIT_CPY(&se_mem[AFFINE_BG_SBB], affine_background_gfxMap);
+        bg_assets_show(BG_ASSET_AFFINE_GAME);
+        affine_background_load_map(affine_background_gfxMap, affine_background_gfxMapLen, BG_ASSET_AFFINE_GAME);
         affine_background_load_palette(affine_background_gfxPal);
         break;
     }
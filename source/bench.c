@@ -0,0 +1,449 @@
+#include "bench.h"
+
+#ifdef BENCH
+
+#include <stdio.h>
+#include <tonc.h>
+
+#include "affine_background.h"
+#include "card.h"
+#include "cycle_counter.h"
+#include "game.h"
+#include "graphic_utils.h"
+#include "hand_analysis.h"
+#include "hand_histogram.h"
+#include "joker.h"
+#include "list.h"
+#include "mgba_log.h"
+#include "save.h"
+#include "solver.h"
+#include "sprite.h"
+#include "util.h"
+#include "vram_queue.h"
+
+#define BENCH_SEED 1
+#define BENCH_MAX_SETUP_FRAMES (60 * 60) // Getting to the first hand takes a few seconds
+#define BENCH_HAND_SIZE 5
+#define BENCH_HELD_SIZE 3
+#define BENCH_LIST_SIZE 32
+#define BENCH_NAME_LEN 32
+#define BENCH_SOLVER_HAND_SIZE (BENCH_HAND_SIZE + BENCH_HELD_SIZE)
+
+// Same as TOP_LEFT_ITEM_SRC_RECT in game.c, copied onto itself so the screen doesn't change
+static const Rect BENCH_SE_RECT = {0, 20, 8, 25};
+
+typedef void (*BenchFunc)(int arg);
+
+typedef struct
+{
+    Card cards[BENCH_HAND_SIZE];
+    Card held_cards[BENCH_HELD_SIZE];
+    HandContext context;
+    Card *scoring_cards[BENCH_HAND_SIZE];
+    int num_scoring_cards;
+} BenchHand;
+
+LIST_DEFINE(BenchHand *, BenchHandList, bench_hand_list, BENCH_LIST_SIZE)
+
+static EWRAM_BSS BenchHand corpus[BENCH_CORPUS_SIZE]; // 8KB, too much for IWRAM. The game's cards are in EWRAM too
+static u32 timing_overhead = 0;
+static u32 lcg_state = BENCH_SEED;
+
+static Joker *bench_joker = NULL;
+static BenchHandList bench_list;
+
+// A mix of the joker kinds the solver treats differently: play invariant, per scored card,
+// reading the distribution and reading the held cards
+static const u8 bench_solver_joker_ids[] = { DEFAULT_JOKER_ID, GREEDY_JOKER_ID, 5 /* Jolly */, 20 /* Blackboard */ };
+#define BENCH_SOLVER_NUM_JOKERS (sizeof(bench_solver_joker_ids) / sizeof(bench_solver_joker_ids[0]))
+static Joker *bench_solver_jokers[BENCH_SOLVER_NUM_JOKERS];
+static JokerDispatch bench_solver_dispatch;
+static Solver bench_solver;
+static Card *bench_solver_hand[BENCH_SOLVER_HAND_SIZE];
+static int bench_solver_next_hand = 0;
+static volatile int bench_sink = 0; // Keeps results that are otherwise unused from being optimized out
+
+// Own generator so the corpus doesn't change with the game's RNG
+static int bench_random(int n)
+{
+    lcg_state = lcg_state * 1664525 + 1013904223;
+    return (lcg_state >> 16) % n;
+}
+
+static void bench_card_random(Card *card)
+{
+    card->suit = bench_random(NUM_SUITS);
+    card->rank = bench_random(NUM_RANKS);
+}
+
+static void bench_corpus_init(void)
+{
+    for (int i = 0; i < BENCH_CORPUS_SIZE; i++)
+    {
+        BenchHand *hand = &corpus[i];
+        for (int j = 0; j < BENCH_HAND_SIZE; j++)
+        {
+            bench_card_random(&hand->cards[j]);
+            // Every other hand shares a suit, otherwise flushes would almost never come up
+            if (i % 2 == 1)
+            {
+                hand->cards[j].suit = hand->cards[0].suit;
+            }
+        }
+        for (int j = 0; j < BENCH_HELD_SIZE; j++)
+        {
+            bench_card_random(&hand->held_cards[j]);
+        }
+
+        HandDistribution dist;
+        hand_distribution_clear(&dist);
+        Card *played[BENCH_HAND_SIZE];
+        for (int j = 0; j < BENCH_HAND_SIZE; j++)
+        {
+            played[j] = &hand->cards[j];
+            hand_distribution_add_card(&dist, played[j]);
+        }
+        enum HandType hand_type = hand_distribution_get_type(&dist);
+
+        bool is_scoring[BENCH_HAND_SIZE];
+        hand_get_scoring_cards(played, BENCH_HAND_SIZE, hand_type, is_scoring);
+        hand->num_scoring_cards = 0;
+        for (int j = 0; j < BENCH_HAND_SIZE; j++)
+        {
+            if (is_scoring[j])
+            {
+                hand->scoring_cards[hand->num_scoring_cards++] = played[j];
+            }
+        }
+
+        Card *held[BENCH_HELD_SIZE];
+        for (int j = 0; j < BENCH_HELD_SIZE; j++)
+        {
+            held[j] = &hand->held_cards[j];
+        }
+        hand_context_make(&hand->context, hand_type, BENCH_HAND_SIZE, hand->scoring_cards, hand->num_scoring_cards,
+                          held, BENCH_HELD_SIZE);
+    }
+}
+
+// Plays from the splash screen into the first hand, pressing A every other frame like the simulator
+static bool bench_play_to_first_hand(void)
+{
+    for (int frame = 0; frame < BENCH_MAX_SETUP_FRAMES; frame++)
+    {
+        if (game_get_state() == GAME_PLAYING && hand_get_state() == HAND_SELECT && hand_get_size() > 0)
+            return true;
+
+        if (game_get_state() == GAME_MAIN_MENU)
+        {
+            set_seed(BENCH_SEED);
+            save_erase(); // Always a new run, never one saved by an earlier bench
+        }
+
+        VBlankIntrWait();
+        affine_background_vblank();
+        vram_queue_flush();
+        __key_prev = __key_curr;
+        __key_curr = frame % 2 == 0 ? SELECT_CARD : 0;
+        affine_background_update();
+        game_update();
+        save_update();
+        sprite_draw();
+    }
+
+    return false;
+}
+
+static void bench_time(const char *name, BenchFunc setup, BenchFunc kernel, int arg)
+{
+    u32 total = 0;
+    u32 min = UINT32_MAX;
+
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        if (setup != NULL)
+        {
+            setup(arg);
+        }
+
+        REG_IME = 0;
+        u32 start = cycle_counter_read();
+        kernel(arg);
+        u32 cycles = cycle_counter_read() - start;
+        REG_IME = 1;
+
+        cycles = cycles > timing_overhead ? cycles - timing_overhead : 0;
+        total += cycles;
+        min = cycles < min ? cycles : min;
+    }
+
+    mgba_logf(MGBA_LOG_INFO, "bench,%s,%d,%lu,%lu", name, BENCH_ITERATIONS,
+              (unsigned long)(total / BENCH_ITERATIONS), (unsigned long)min);
+}
+
+static void bench_nothing(int arg)
+{
+}
+
+// Kernels
+
+static void bench_hand_type(int arg)
+{
+    for (int i = 0; i < BENCH_CORPUS_SIZE; i++)
+    {
+        HandDistribution dist;
+        hand_distribution_clear(&dist);
+        for (int j = 0; j < BENCH_HAND_SIZE; j++)
+        {
+            hand_distribution_add_card(&dist, &corpus[i].cards[j]);
+        }
+        bench_sink += hand_distribution_get_type(&dist);
+    }
+}
+
+// The classifier hand_type replaced, on the same hands
+static void bench_hand_type_histogram(int arg)
+{
+    for (int i = 0; i < BENCH_CORPUS_SIZE; i++)
+    {
+        u8 ranks[NUM_RANKS] = {0};
+        u8 suits[NUM_SUITS] = {0};
+        for (int j = 0; j < BENCH_HAND_SIZE; j++)
+        {
+            hand_histogram_add_card(ranks, suits, &corpus[i].cards[j]);
+        }
+        bench_sink += hand_histogram_get_type(ranks, suits);
+    }
+}
+
+static void bench_joker_scored(int joker_id)
+{
+    JokerEffectFunc effect = get_joker_registry_entry(joker_id)->effect;
+    for (int i = 0; i < BENCH_CORPUS_SIZE; i++)
+    {
+        for (int j = 0; j < corpus[i].num_scoring_cards; j++)
+        {
+            bench_sink += effect(bench_joker, corpus[i].scoring_cards[j], &corpus[i].context).chips;
+        }
+    }
+}
+
+static void bench_joker_independent(int joker_id)
+{
+    JokerEffectFunc effect = get_joker_registry_entry(joker_id)->effect;
+    for (int i = 0; i < BENCH_CORPUS_SIZE; i++)
+    {
+        bench_sink += effect(bench_joker, NULL, &corpus[i].context).chips;
+    }
+}
+
+// The whole search over one corpus hand with its held cards, a different one every iteration
+static void bench_solver_pick_hand(int arg)
+{
+    BenchHand *hand = &corpus[bench_solver_next_hand];
+    bench_solver_next_hand = (bench_solver_next_hand + 1) % BENCH_CORPUS_SIZE;
+
+    for (int i = 0; i < BENCH_HAND_SIZE; i++)
+    {
+        bench_solver_hand[i] = &hand->cards[i];
+    }
+    for (int i = 0; i < BENCH_HELD_SIZE; i++)
+    {
+        bench_solver_hand[BENCH_HAND_SIZE + i] = &hand->held_cards[i];
+    }
+}
+
+static void bench_solver_solve(int arg)
+{
+    solver_start(&bench_solver, bench_solver_hand, BENCH_SOLVER_HAND_SIZE, &bench_solver_dispatch);
+    solver_solve(&bench_solver);
+    bench_sink += bench_solver.best_score;
+}
+
+static void bench_solver_run(void)
+{
+    int num_jokers = 0;
+    for (int i = 0; i < BENCH_SOLVER_NUM_JOKERS; i++)
+    {
+        bench_solver_jokers[num_jokers] = joker_new(bench_solver_joker_ids[i]);
+        if (bench_solver_jokers[num_jokers] != NULL)
+        {
+            num_jokers++;
+        }
+    }
+    joker_dispatch_build(&bench_solver_dispatch, bench_solver_jokers, num_jokers);
+
+    bench_time("solver", bench_solver_pick_hand, bench_solver_solve, 0);
+
+    for (int i = 0; i < num_jokers; i++)
+    {
+        joker_destroy(&bench_solver_jokers[i]);
+    }
+}
+
+static void bench_hand_scramble(int arg)
+{
+    CardObject **hand = get_hand_array();
+    int size = hand_get_size();
+    for (int i = size - 1; i > 0; i--)
+    {
+        int j = bench_random(i + 1);
+        CardObject *temp = hand[i];
+        hand[i] = hand[j];
+        hand[j] = temp;
+    }
+}
+
+static void bench_sort_cards(int arg)
+{
+    sort_cards();
+}
+
+static void bench_deck_shuffle(int arg)
+{
+    deck_shuffle();
+}
+
+static void bench_list_clear(int arg)
+{
+    bench_hand_list_clear(&bench_list);
+}
+
+static void bench_list_fill(int arg)
+{
+    bench_hand_list_clear(&bench_list);
+    for (int i = 0; i < BENCH_LIST_SIZE; i++)
+    {
+        bench_hand_list_append(&bench_list, &corpus[i]);
+    }
+}
+
+static void bench_list_append_all(int arg)
+{
+    for (int i = 0; i < BENCH_LIST_SIZE; i++)
+    {
+        bench_hand_list_append(&bench_list, &corpus[i]);
+    }
+}
+
+// From the front, the worst case for keeping the order
+static void bench_list_remove_all(int arg)
+{
+    for (int i = 0; i < BENCH_LIST_SIZE; i++)
+    {
+        bench_hand_list_remove(&bench_list, 0);
+    }
+}
+
+static void bench_list_swap_remove_all(int arg)
+{
+    for (int i = 0; i < BENCH_LIST_SIZE; i++)
+    {
+        bench_hand_list_swap_remove(&bench_list, 0);
+    }
+}
+
+static void bench_main_bg_se_copy_rect(int arg)
+{
+    main_bg_se_copy_rect(BENCH_SE_RECT, (BG_POINT){BENCH_SE_RECT.left, BENCH_SE_RECT.top});
+}
+
+static void bench_hand_shake(int arg)
+{
+    CardObject **hand = get_hand_array();
+    for (int i = 0; i < hand_get_size(); i++)
+    {
+        sprite_object_shake(hand[i]->sprite_object, UNDEFINED);
+    }
+}
+
+static void bench_sprite_object_update(int arg)
+{
+    CardObject **hand = get_hand_array();
+    for (int i = 0; i < hand_get_size(); i++)
+    {
+        sprite_object_update(hand[i]->sprite_object);
+    }
+}
+
+static void bench_affine_background_update(int arg)
+{
+    affine_background_update();
+}
+
+static void bench_jokers(void)
+{
+    char name[BENCH_NAME_LEN];
+    for (int id = 0; id < get_joker_registry_size(); id++)
+    {
+        const JokerInfo *info = get_joker_registry_entry(id);
+        if (info->effect == NULL)
+            continue;
+
+        bench_joker = joker_new(id);
+        if (bench_joker == NULL)
+            continue;
+
+        if (info->phases & JOKER_ON_SCORED)
+        {
+            snprintf(name, sizeof(name), "joker_%d_scored", id);
+            bench_time(name, NULL, bench_joker_scored, id);
+        }
+        if (info->phases & (JOKER_INDEPENDENT | JOKER_HELD))
+        {
+            snprintf(name, sizeof(name), "joker_%d_independent", id);
+            bench_time(name, NULL, bench_joker_independent, id);
+        }
+
+        joker_destroy(&bench_joker);
+    }
+}
+
+void bench_run(void)
+{
+    cycle_counter_init();
+    mgba_log_init();
+    bench_corpus_init();
+
+    // The cost of reading the counter twice, taken off every measurement
+    timing_overhead = UINT32_MAX;
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        u32 start = cycle_counter_read();
+        bench_nothing(0);
+        u32 cycles = cycle_counter_read() - start;
+        timing_overhead = min(timing_overhead, cycles);
+    }
+
+    mgba_logf(MGBA_LOG_INFO, "bench,kernel,iterations,avg_cycles,min_cycles");
+
+    bench_time("hand_type", NULL, bench_hand_type, 0);
+    bench_time("hand_type_histogram", NULL, bench_hand_type_histogram, 0);
+    bench_jokers();
+    bench_solver_run();
+    bench_time("list_append", bench_list_clear, bench_list_append_all, 0);
+    bench_time("list_remove", bench_list_fill, bench_list_remove_all, 0);
+    bench_time("list_swap_remove", bench_list_fill, bench_list_swap_remove_all, 0);
+    bench_time("affine_background_update", NULL, bench_affine_background_update, 0);
+
+    // The rest need the game's own hand, deck and background
+    if (bench_play_to_first_hand())
+    {
+        bench_time("sort_cards", bench_hand_scramble, bench_sort_cards, 0);
+        bench_time("deck_shuffle", NULL, bench_deck_shuffle, 0);
+        bench_time("main_bg_se_copy_rect", NULL, bench_main_bg_se_copy_rect, 0);
+        bench_time("sprite_object_update", bench_hand_shake, bench_sprite_object_update, 0);
+    }
+    else
+    {
+        mgba_logf(MGBA_LOG_ERROR, "bench: didn't get to the first hand in %d frames", BENCH_MAX_SETUP_FRAMES);
+    }
+
+    mgba_logf(MGBA_LOG_INFO, "bench,done");
+    while (true)
+    {
+        Stop();
+    }
+}
+
+#endif // BENCH
@@ -0,0 +1,85 @@
+#include "bg_assets.h"
+#include "affine_background.h"
+#include "graphic_utils.h"
+#include "util.h"
+#include "vram_queue.h"
+
+#include "background_gfx.h"
+#include "background_shop_gfx.h"
+#include "background_blind_select_gfx.h"
+#include "background_main_menu_gfx.h"
+#include "affine_background_gfx.h"
+#include "affine_main_menu_background_gfx.h"
+
+typedef struct
+{
+    const u32 *tiles;
+    u32 tiles_len;  // In bytes
+    u8 bg_idx;      // The layer showing it
+    u8 cbb;
+    u16 first_tile; // In 8bpp tiles from the start of the CBB
+    u8 pal_offset;  // Added to every pixel when copying, see memcpy32_tile8_with_palette_offset()
+} BgAsset;
+
+#define BG_ASSET(name, bg_idx, cbb, first_tile, pal_offset) \
+    { (const u32 *)name##Tiles, name##TilesLen, bg_idx, cbb, first_tile, pal_offset }
+
+static const BgAsset assets[BG_ASSET_COUNT] =
+{
+    [BG_ASSET_GAME]             = BG_ASSET(background_gfx,                  MAIN_BG_IDX,    0, 0,                           0),
+    [BG_ASSET_SHOP]             = BG_ASSET(background_shop_gfx,             MAIN_BG_IDX,    1, 0,                           0),
+    [BG_ASSET_BLIND_SELECT]     = BG_ASSET(background_blind_select_gfx,     MAIN_BG_IDX,    2, 0,                           0),
+    [BG_ASSET_MAIN_MENU]        = BG_ASSET(background_main_menu_gfx,        MAIN_BG_IDX,    1, 0,                           0),
+    [BG_ASSET_AFFINE_GAME]      = BG_ASSET(affine_background_gfx,           AFFINE_BG_IDX,  3, BG_ASSETS_AFFINE_GAME_TILE,  AFFINE_BG_PB),
+    [BG_ASSET_AFFINE_MAIN_MENU] = BG_ASSET(affine_main_menu_background_gfx, AFFINE_BG_IDX,  2, 0,                           AFFINE_BG_PB),
+};
+
+// The asset whose tiles are in each CBB
+static int cbb_contents[BG_ASSETS_NUM_CBBS] = {UNDEFINED, UNDEFINED, UNDEFINED, UNDEFINED};
+static BgAssetsStats stats = {0};
+
+static void bg_assets_load(enum BgAssetID id)
+{
+    const BgAsset *asset = &assets[id];
+    u32 *dst = (u32 *)&tile8_mem[asset->cbb][asset->first_tile];
+
+    if (asset->pal_offset == 0)
+    {
+        vram_queue_copy32(dst, asset->tiles, asset->tiles_len / 4);
+    }
+    else
+    {
+        // The offset has to be added by the CPU, the DMA can only copy.
+        // Whatever is still queued for this CBB has to land first or it would overwrite these tiles
+        vram_queue_flush_now();
+        memcpy32_tile8_with_palette_offset(dst, asset->tiles, asset->tiles_len / 4, asset->pal_offset);
+    }
+
+    cbb_contents[asset->cbb] = id;
+}
+
+void bg_assets_show(enum BgAssetID id)
+{
+    const BgAsset *asset = &assets[id];
+    if (cbb_contents[asset->cbb] == id)
+    {
+        stats.hits++;
+    }
+    else
+    {
+        stats.loads++;
+        bg_assets_load(id);
+    }
+
+    REG_BGCNT[asset->bg_idx] = (REG_BGCNT[asset->bg_idx] & ~BG_CBB_MASK) | BG_CBB(asset->cbb);
+}
+
+int bg_assets_get_first_tile(enum BgAssetID id)
+{
+    return assets[id].first_tile;
+}
+
+const BgAssetsStats *bg_assets_get_stats(void)
+{
+    return &stats;
+}
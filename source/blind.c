@@ -5,6 +5,8 @@
 #include "big_blind_gfx.h"
 #include "boss_blind_gfx.h"
 #include "graphic_utils.h"
+#include "tile_cache.h"
+#include "pal_bank.h"
 
 // +1 is added because we'll actually be indexing at 1, but if something causes you to go to ante 0, there will still be a value there.
 static const int ante_lut[MAX_ANTE + 1] = {100, 300, 800, 2000, 5000, 11000, 20000, 35000, 50000};
@@ -24,8 +26,6 @@ static Blind _blind_type_map[BLIND_TYPE_MAX] =
         {                                                \
             .tiles = name##_blind_gfxTiles,              \
             .palette = name##_blind_token_palette,       \
-            .tid = NAME##_BLIND_TID,                     \
-            .pb = NAME##_BLIND_PB,                       \
         },                                               \
         .score_req_multipler = multi ,                   \
         .reward = _reward ,                              \
@@ -36,12 +36,10 @@ static Blind _blind_type_map[BLIND_TYPE_MAX] =
 
 static void blind_gfx_init(enum BlindType type)
 {
-    // TODO: Re-add grit copy. You need to decouple the blind graphics first.
-    // This will allow this function to change the boss graphics info
-    //GRIT_CPY(&tile_mem[4][_blind_type_map[type].pal_info.tid], tiles);
+    // The tiles are copied by the tile cache when a token is shown, or over the cached ones if they changed.
+    // The palette is copied to a bank by pal_bank_acquire() when a token is shown
     BlindGfxInfo* p_gfx = &_blind_type_map[type].gfx_info;
-    memcpy32(&tile_mem[4][p_gfx->tid], p_gfx->tiles, BLIND_SPRITE_COPY_SIZE);
-    memcpy16(&pal_obj_bank[p_gfx->pb], p_gfx->palette, PAL_ROW_LEN);
+    tile_cache_update(TILE_CACHE_KEY(TILE_CACHE_BLIND, type), p_gfx->tiles);
 }
 
 
@@ -93,9 +91,12 @@ Sprite *blind_token_new(enum BlindType type, int x, int y, int sprite_index)
 {
     u16 a0 = ATTR0_SQUARE | ATTR0_4BPP;
     u16 a1 = ATTR1_SIZE_32x32;
-    u32 tid = _blind_type_map[type].gfx_info.tid, pb = _blind_type_map[type].gfx_info.pb;
+    u32 pb = pal_bank_acquire(_blind_type_map[type].gfx_info.palette);
+    int tid = tile_cache_acquire(TILE_CACHE_KEY(TILE_CACHE_BLIND, type), _blind_type_map[type].gfx_info.tiles);
 
     Sprite* sprite = sprite_new(a0, a1, tid, pb, sprite_index);
+    if (sprite == NULL)
+        return NULL; // sprite_new() has released the palette bank and the tiles
 
     sprite_position(sprite, x, y);
 
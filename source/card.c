@@ -1,10 +1,11 @@
 #include "card.h"
 
 #include <maxmod.h>
-#include <stdlib.h>
 
 #include "deck_gfx.h"
 #include "graphic_utils.h"
+#include "tile_cache.h"
+#include "pal_bank.h"
 
 // Audio
 #include "soundbank.h"
@@ -17,15 +18,24 @@ const static u16 card_sprite_lut[NUM_SUITS][NUM_RANKS] = {
     {624, 640, 656, 672, 688, 704, 720, 736, 752, 768, 784, 800, 816}
 };
 
-void card_init()
+POOL_DEFINE(Card, card_pool, MAX_CARDS);
+POOL_DEFINE(CardObject, card_object_pool, MAX_CARD_OBJECTS);
+
+const Pool *card_get_pool(void)
 {
-    GRIT_CPY(&pal_obj_mem[CARD_PB], deck_gfxPal);
+    return &card_pool;
+}
+
+const Pool *card_object_get_pool(void)
+{
+    return &card_object_pool;
 }
 
 // Card methods
 Card *card_new(u8 suit, u8 rank)
 {
-    Card *card = malloc(sizeof(Card));
+    Card *card = card_pool_alloc();
+    if (card == NULL) return NULL;
 
     card->suit = suit;
     card->rank = rank;
@@ -33,14 +43,24 @@ Card *card_new(u8 suit, u8 rank)
     return card;
 }
 
+Card *card_new_from_code(CardCode code)
+{
+    return card_new(card_code_get_suit(code), card_code_get_rank(code));
+}
+
 void card_destroy(Card **card)
 {
     if (*card == NULL) return;
-    free(*card);
+    card_pool_free(*card);
     *card = NULL;
 }
 
-u8 card_get_value(Card *card)
+CardCode card_get_code(const Card *card)
+{
+    return card_code_make(card->suit, card->rank);
+}
+
+ARM_IWRAM_CODE u8 card_get_value(Card *card)
 {
     if (card->rank == JACK || card->rank == QUEEN || card->rank == KING)
     {
@@ -61,7 +81,8 @@ u8 card_get_value(Card *card)
 // CardObject methods
 CardObject *card_object_new(Card *card)
 {
-    CardObject *card_object = malloc(sizeof(CardObject));
+    CardObject *card_object = card_object_pool_alloc();
+    if (card_object == NULL) return NULL;
 
     card_object->card = card;
     card_object->sprite_object = sprite_object_new();
@@ -73,8 +94,8 @@ void card_object_destroy(CardObject **card_object)
 {
     if (*card_object == NULL) return;
     sprite_object_destroy(&((*card_object)->sprite_object));
-    //card_destroy(&(*card_object)->card); // In practice, this is unnecessary because the card will be inserted into the discard pile and then back into the deck. If you need to destroy the card, you can do it manually before calling this function.
-    free(*card_object);
+    card_destroy(&(*card_object)->card);
+    card_object_pool_free(*card_object);
     *card_object = NULL;
 }
 
@@ -84,11 +105,14 @@ void card_object_update(CardObject* card_object)
     sprite_object_update(card_object->sprite_object);
 }
 
-void card_object_set_sprite(CardObject *card_object, int layer)
+bool card_object_set_sprite(CardObject *card_object, int layer)
 {
-    int tile_index = CARD_TID + (layer * CARD_SPRITE_OFFSET);
-    memcpy32(&tile_mem[4][tile_index], &deck_gfxTiles[card_sprite_lut[card_object->card->suit][card_object->card->rank] * TILE_SIZE], TILE_SIZE * CARD_SPRITE_OFFSET);
-    sprite_object_set_sprite(card_object->sprite_object, sprite_new(ATTR0_SQUARE | ATTR0_4BPP | ATTR0_AFF, ATTR1_SIZE_32, tile_index, 0, layer + CARD_STARTING_LAYER));
+    Card *card = card_object->card;
+    u16 key = TILE_CACHE_KEY(TILE_CACHE_CARD, card->suit * NUM_RANKS + card->rank);
+    int tile_index = tile_cache_acquire(key, &deck_gfxTiles[card_sprite_lut[card->suit][card->rank] * TILE_SIZE]);
+    int pb = pal_bank_acquire(deck_gfxPal); // Only the first bank of the grit palette is used, the deck is 4bpp
+    sprite_object_set_sprite(card_object->sprite_object, sprite_new(ATTR0_SQUARE | ATTR0_4BPP | ATTR0_AFF, ATTR1_SIZE_32, tile_index, pb, layer + CARD_STARTING_LAYER));
+    return sprite_object_get_sprite(card_object->sprite_object) != NULL;
 }
 
 void card_object_shake(CardObject* card_object, mm_word sound_id)
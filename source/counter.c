@@ -0,0 +1,113 @@
+#include "counter.h"
+#include "util.h"
+
+#define ONE_K 1000
+
+/* Writes prefix, value and its suffix to text and returns the length, no null terminator.
+ * ARM code so the divisions by constants become multiplications instead of calls to the BIOS.
+ */
+ARM_IWRAM_CODE static int counter_format(char *text, char prefix, int abbreviate_from, int value)
+{
+    int len = 0;
+    if (prefix != 0)
+    {
+        text[len++] = prefix;
+    }
+
+    if (value < 0)
+    {
+        text[len++] = '-';
+    }
+
+    // Unsigned so INT_MIN can be negated
+    u32 magnitude = value < 0 ? -(u32)value : (u32)value;
+    char suffix = 0;
+    if (abbreviate_from > 0 && magnitude >= (u32)abbreviate_from)
+    {
+        if (magnitude / ONE_K >= (u32)abbreviate_from)
+        {
+            magnitude /= ONE_K * ONE_K;
+            suffix = 'M';
+        }
+        else
+        {
+            magnitude /= ONE_K;
+            suffix = 'k';
+        }
+    }
+
+    char digits[INT_MAX_DIGITS];
+    int num_digits = 0;
+    do
+    {
+        digits[num_digits++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    while (num_digits > 0)
+    {
+        text[len++] = digits[--num_digits];
+    }
+
+    if (suffix != 0)
+    {
+        text[len++] = suffix;
+    }
+
+    return len;
+}
+
+/* Shows text from text_col on and blanks the rest of [first_col, end_col) on the TTE row,
+ * writing only the screen entries that change.
+ */
+static void counter_write_row(int row, int first_col, int end_col, int text_col, const char *text, int len, u16 pb)
+{
+    SE *row_se = se_mat[TTE_SBB][row];
+    int start = max(0, min(first_col, text_col));
+    int end = min(SE_ROW_LEN, max(end_col, text_col + len));
+
+    for (int col = start; col < end; col++)
+    {
+        int i = col - text_col;
+        SE se = (i >= 0 && i < len) ? TTE_GLYPH_SE(text[i], pb) : TTE_BLANK_SE;
+        if (row_se[col] != se)
+        {
+            row_se[col] = se;
+        }
+    }
+}
+
+void counter_draw(const Counter *counter, int value)
+{
+    char text[COUNTER_MAX_CHARS];
+    int len = counter_format(text, counter->prefix, counter->abbreviate_from, value);
+
+    const Rect *rect = &counter->rect;
+    // The same screen entries as tte_erase_rect() clears
+    int first_col = rect->left / TILE_SIZE;
+    int end_col = (rect->right + TILE_SIZE - 1) / TILE_SIZE;
+    int text_col = first_col;
+
+    switch (counter->align)
+    {
+        case COUNTER_ALIGN_LEFT:
+            break;
+        case COUNTER_ALIGN_RIGHT:
+            text_col = max(0, end_col - len);
+            break;
+        case COUNTER_ALIGN_CENTER:
+            text_col = max(0, rect->left + (rect->right - rect->left - len * TTE_CHAR_SIZE) / 2) / TILE_SIZE;
+            break;
+    }
+
+    counter_write_row(rect->top / TILE_SIZE, first_col, end_col, text_col, text, len, counter->pb);
+}
+
+void counter_draw_at(int x, int y, u16 pb, char prefix, int value)
+{
+    char text[COUNTER_MAX_CHARS];
+    int len = counter_format(text, prefix, 0, value);
+    int text_col = x / TILE_SIZE;
+
+    counter_write_row(y / TILE_SIZE, text_col, text_col, text_col, text, len, pb);
+}
@@ -11,14 +11,23 @@
 #include "sprite.h"
 #include "card.h"
 #include "hand_analysis.h"
+#include "scoring.h"
+#include "rng.h"
+#include "solver.h"
 #include "blind.h"
 #include "joker.h"
+#include "counter.h"
 #include "affine_background.h"
 #include "graphic_utils.h"
 #include "tonc_video.h"
 #include "audio_utils.h"
 #include "selection_grid.h"
 #include "splash_screen.h"
+#include "vram_queue.h"
+#include "bg_assets.h"
+#include "profiler.h"
+#include "input_trace.h"
+#include "save.h"
 
 #include "background_gfx.h"
 #include "background_shop_gfx.h"
@@ -65,6 +74,7 @@ static uint rng_seed = 0;
 static uint timer = 0; // This might already exist in libtonc but idk so i'm just making my own
 static int game_speed = 1; // BY DEFAULT IS SET TO 1, but if changed to 2 or more, should speed up all (or most) of the game aspects that should be sped up by speed, as in the original game.
 static int background = 0;
+static int shop_lights_phase = 0; // How many lights the shop light colors have turned since they were reset
 
 static enum GameState game_state = GAME_SPLASH_SCREEN; // The current game state, this is used to determine what the game is doing at any given time
 static enum HandState hand_state = HAND_DRAW;
@@ -72,6 +82,10 @@ static enum PlayState play_state = PLAY_PLAYING;
 static int state = 0; // General state variable, used for switch statements in each game state related function
 
 static enum HandType hand_type = NONE;
+static HandContext hand_context; // The played hand as seen by the jokers, valid during PLAY_SCORING
+static ScoreResult score_result; // Computed when the played hand starts scoring, then replayed by the animation
+static int scoring_event_idx = 0; // The next event of score_result to animate
+static int scoring_card_played_idx[MAX_SELECTION_SIZE]; // Maps score_hand()'s scoring card indices to the played array
 
 static CardObject *main_menu_ace = NULL;
 
@@ -117,9 +131,12 @@ static int selection_y = 0;
 
 static bool sort_by_suit = false;
 
-static List *jokers = NULL;
-static List *discarded_jokers = NULL;
-static List *jokers_available_to_shop; // List of joker IDs
+LIST_DEFINE(u8, JokerIdList, joker_id_list, NUM_JOKERS)
+
+static JokerObjectList jokers;
+static JokerDispatch joker_dispatch; // The held jokers by scoring phase, rebuilt whenever they change
+static JokerObjectList discarded_jokers;
+static JokerIdList jokers_available_to_shop;
 
 // Stacks
 static CardObject *played[MAX_SELECTION_SIZE] = {NULL};
@@ -128,10 +145,11 @@ static int played_top = -1;
 static CardObject *hand[MAX_HAND_SIZE] = {NULL};
 static int hand_top = -1;
 
-static Card *deck[MAX_DECK_SIZE] = {NULL};
+// Outside the hand cards are only their CardCode, so the deck is one contiguous array
+static EWRAM_BSS CardCode deck[MAX_DECK_SIZE];
 static int deck_top = -1;
 
-static Card *discard_pile[MAX_DECK_SIZE] = {NULL};
+static EWRAM_BSS CardCode discard_pile[MAX_DECK_SIZE];
 static int discard_top = -1;
 
 // Played stack
@@ -148,28 +166,28 @@ static inline CardObject *played_pop()
 }
 
 // Deck stack
-static inline void deck_push(Card *card)
+static inline void deck_push(CardCode card)
 {
     if (deck_top >= MAX_DECK_SIZE - 1) return;
     deck[++deck_top] = card;
 }
 
-static inline Card *deck_pop()
+// The deck must not be empty
+static inline CardCode deck_pop()
 {
-    if (deck_top < 0) return NULL;
     return deck[deck_top--];
 }
 
 // Discard stack
-static inline void discard_push(Card *card)
+static inline void discard_push(CardCode card)
 {
     if (discard_top >= MAX_DECK_SIZE - 1) return;
     discard_pile[++discard_top] = card;
 }
 
-static inline Card *discard_pop()
+// The discard pile must not be empty
+static inline CardCode discard_pop()
 {
-    if (discard_top < 0) return NULL;
     return discard_pile[discard_top--];
 }
 
@@ -195,14 +213,14 @@ int get_played_top(void) {
     return played_top;
 }
 
-List *get_jokers(void) {
-    return jokers;
+JokerObjectList *get_jokers(void) {
+    return &jokers;
 }
 
 bool is_joker_owned(int joker_id) {
-    for (int k = 0; k < list_get_size(jokers); k++)
+    for (int k = 0; k < jokers.size; k++)
     {
-        JokerObject *joker = list_get(jokers, k);
+        JokerObject *joker = jokers.items[k];
         if (joker->joker->id == joker_id)
         {
             return true;
@@ -211,14 +229,32 @@ bool is_joker_owned(int joker_id) {
     return false;
 }
 
+const JokerDispatch *get_joker_dispatch(void) {
+    return &joker_dispatch;
+}
+
+static void joker_dispatch_rebuild(void)
+{
+    Joker *held_jokers[MAX_JOKERS_HELD_SIZE];
+    int num_jokers = 0;
+    for (int i = 0; i < jokers.size; i++)
+    {
+        held_jokers[num_jokers++] = jokers.items[i]->joker;
+    }
+
+    joker_dispatch_build(&joker_dispatch, held_jokers, num_jokers);
+}
+
 void add_joker(JokerObject *joker_object)
 {
-    list_append(jokers, joker_object);
+    joker_object_list_append(&jokers, joker_object);
+    joker_dispatch_rebuild();
 }
 
 void remove_held_joker(int joker_idx)
 {
-    list_remove_by_idx(jokers, joker_idx);
+    joker_object_list_remove(&jokers, joker_idx);
+    joker_dispatch_rebuild();
 }
 
 int get_deck_top(void)
@@ -251,6 +287,41 @@ int get_money(void)
     return money;
 }
 
+int get_ante(void)
+{
+    return ante;
+}
+
+int get_score(void)
+{
+    return score;
+}
+
+enum GameState game_get_state(void)
+{
+    return game_state;
+}
+
+enum HandState hand_get_state(void)
+{
+    return hand_state;
+}
+
+enum PlayState play_get_state(void)
+{
+    return play_state;
+}
+
+int hand_get_focus(void)
+{
+    return selection_x;
+}
+
+const ScoreResult *get_score_result(void)
+{
+    return &score_result;
+}
+
 // Consts
 
 // Rects                                       left     top     right   bottom
@@ -292,15 +363,9 @@ static const Rect HAND_SIZE_RECT            = {128,     128,    152,    160 }; /
 static const Rect HAND_SIZE_RECT_SELECT     = {128,     128,    152,    136 };
 static const Rect HAND_SIZE_RECT_PLAYING    = {128,     152,    152,    160 };
 static const Rect HAND_TYPE_RECT            = {8,       64,     64,     72  };
-// Score displayed in the same place as the hand type
-static const Rect TEMP_SCORE_RECT           = {8,       64,     64,     72  }; 
-static const Rect SCORE_RECT                = {32,      48,     64,     56  };
 
 static const Rect PLAYED_CARDS_SCORES_RECT  = {72,      48,     240,    56  };
 static const Rect BLIND_TOKEN_TEXT_RECT     = {80,      72,     200,    160 };
-static const Rect MONEY_TEXT_RECT           = {8,       120,    64,     128 };
-static const Rect CHIPS_TEXT_RECT           = {8,       80,     32,     88  };
-static const Rect MULT_TEXT_RECT            = {40,      80,     64,     88  };
 static const Rect BLIND_REWARD_RECT         = {40,      32,     64,     40  };
 static const Rect BLIND_REQ_TEXT_RECT       = {32,      24,     64,     32  };
 static const Rect SHOP_PRICES_TEXT_RECT     = {72,      56,     192,    160 };
@@ -346,6 +411,7 @@ static const BG_POINT MAIN_MENU_ACE_T       = {88,      26};
 #define SHOP_LIGHTS_2_CLR 0x32BE
 #define SHOP_LIGHTS_3_CLR 0x4B5F
 #define SHOP_LIGHTS_4_CLR 0x5F9F
+#define NUM_SHOP_LIGHTS 4
 
 #define PITCH_STEP_DISCARD_SFX      (-64)
 #define PITCH_STEP_DRAW_SFX         24
@@ -354,6 +420,14 @@ static const BG_POINT MAIN_MENU_ACE_T       = {88,      26};
 #define TEN_K 10000
 #define ONE_K 1000
 
+// Counters for TTE (rects in pixels)
+// Score displayed in the same place as the hand type
+static const Counter TEMP_SCORE_COUNTER     = {{8,      64,     64,     72  }, COUNTER_ALIGN_CENTER,    TTE_WHITE_PB,   0,      0       };
+static const Counter SCORE_COUNTER          = {{32,     48,     64,     56  }, COUNTER_ALIGN_CENTER,    TTE_WHITE_PB,   0,      TEN_K   };
+static const Counter MONEY_COUNTER          = {{8,      120,    64,     128 }, COUNTER_ALIGN_CENTER,    TTE_YELLOW_PB,  '$',    0       };
+static const Counter CHIPS_COUNTER          = {{8,      80,     32,     88  }, COUNTER_ALIGN_RIGHT,     TTE_WHITE_PB,   0,      0       };
+static const Counter MULT_COUNTER           = {{40,     80,     64,     88  }, COUNTER_ALIGN_LEFT,      TTE_WHITE_PB,   0,      0       };
+
 #define CARD_FOCUSED_UNSEL_Y 10
 #define CARD_UNFOCUSED_SEL_Y 15
 #define CARD_FOCUSED_SEL_Y 20
@@ -412,8 +486,8 @@ static const BG_POINT MAIN_MENU_ACE_T       = {88,      26};
 // General functions
 void set_seed(int seed)
 {
-    rng_seed = seed;
-    srand(rng_seed);
+    rng_seed = INPUT_TRACE_SEED(seed);
+    rng_set_seed(rng_seed);
 }
 
 void sort_hand_by_suit()
@@ -459,99 +533,55 @@ void sort_cards()
         sort_hand_by_rank();
     }
 
-    // Update the sprites in the hand by destroying them and creating new ones in the correct order
-    // (This is feels like a diabolical solution but like literally how else would you do this)
+    // Cards keep their layer and tiles for as long as they are in the hand, only the order the layers are drawn in changes.
+    // Newly drawn cards get a layer no other card in the hand uses.
+    bool layer_used[MAX_HAND_SIZE] = {false};
     for (int i = 0; i <= hand_top; i++)
     {
-        if (hand[i] != NULL)
+        Sprite *sprite = hand[i] != NULL ? card_object_get_sprite(hand[i]) : NULL;
+        if (sprite != NULL)
         {
-            // card_object_get_sprite() will not work here since we need the address
-            sprite_destroy(&(hand[i]->sprite_object->sprite));
+            layer_used[sprite_get_layer(sprite) - CARD_STARTING_LAYER] = true;
         }
     }
 
+    Sprite *hand_sprites[MAX_HAND_SIZE];
+    int num_hand_sprites = 0;
     for (int i = 0; i <= hand_top; i++)
     {
-        if (hand[i] != NULL)
+        if (hand[i] == NULL)
+            continue;
+
+        if (card_object_get_sprite(hand[i]) == NULL)
         {
-            //hand[i]->sprite = sprite_new(ATTR0_SQUARE | ATTR0_4BPP | ATTR0_AFF, ATTR1_SIZE_32, card_sprite_lut[hand[i]->card->suit][hand[i]->card->rank], 0, i);
-            card_object_set_sprite(hand[i], i); // Set the sprite for the card object
+            int layer = 0;
+            while (layer_used[layer]) layer++;
+            layer_used[layer] = true;
+
+            if (!card_object_set_sprite(hand[i], layer)) // Set the sprite for the card object
+                continue; // Tried again on the next sort
+
             sprite_position(card_object_get_sprite(hand[i]), fx2int(hand[i]->sprite_object->x), fx2int(hand[i]->sprite_object->y));
         }
+
+        hand_sprites[num_hand_sprites++] = card_object_get_sprite(hand[i]);
     }
+
+    // Drawn in the order of the hand, hand[0] on top
+    sprite_range_set_order(CARD_STARTING_LAYER, MAX_HAND_SIZE, hand_sprites, num_hand_sprites);
 }
 
 enum HandType hand_get_type()
 {
-    enum HandType res_hand_type = NONE;
-
     // Idk if this is how Balatro does it but this is how I'm doing it
     if (hand_selections == 0 || hand_state == HAND_DISCARD)
     {
-        res_hand_type = NONE;
-        return res_hand_type;
-    }
-
-    res_hand_type = HIGH_CARD;
-
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_hand_distribution(ranks, suits);
-
-    // Check for flush
-    if (hand_contains_flush(suits))
-        res_hand_type = FLUSH;
-
-    // Check for straight
-    if (hand_contains_straight(ranks)) {
-        if (res_hand_type == FLUSH)
-            res_hand_type = STRAIGHT_FLUSH;
-        else
-            res_hand_type = STRAIGHT;
-    }
-
-    // Check for royal flush vs regular straight flush
-    if (res_hand_type == STRAIGHT_FLUSH) {
-        if (ranks[TEN] && ranks[JACK] && ranks[QUEEN] && ranks[KING] && ranks[ACE])
-            return ROYAL_FLUSH;
-        return STRAIGHT_FLUSH;
-    }
-
-    // The following can be optimized better but not sure how much it matters
-    u8 n_of_a_kind = hand_contains_n_of_a_kind(ranks);
-
-    if (n_of_a_kind >= 5) {
-        if (res_hand_type == FLUSH) {
-            return FLUSH_FIVE;
-        }
-        return FIVE_OF_A_KIND;
-    }
-
-    if (n_of_a_kind == 4) {
-        return FOUR_OF_A_KIND;
-    }
-
-    if (n_of_a_kind == 3 && hand_contains_full_house(ranks)) {
-        return FULL_HOUSE;
-    }
-
-    // Flush is more valuable than the remaining hand types, so return now
-    if (res_hand_type == FLUSH) {
-        return FLUSH;
-    }
-
-    if (n_of_a_kind == 3) {
-        return THREE_OF_A_KIND;
-    }
-
-    if (n_of_a_kind == 2) {
-        if (hand_contains_two_pair(ranks)) {
-            return TWO_PAIR;
-        }
-        return PAIR;
+        return NONE;
     }
 
-    return res_hand_type; // should be HIGH_CARD
+    HandDistribution dist;
+    get_hand_distribution(&dist);
+    return hand_distribution_get_type(&dist);
 }
 
 // Returns true if the card is *considered* a face card
@@ -573,6 +603,30 @@ void bg_copy_current_item_to_top_left_panel()
     main_bg_se_copy_rect(TOP_LEFT_ITEM_SRC_RECT, TOP_LEFT_PANEL_POINT);
 }
 
+// A blind token is NULL when it didn't get a palette bank or tiles, the screens go on without it
+static void blind_select_token_set_visible(enum BlindType type, bool visible)
+{
+    if (blind_select_tokens[type] == NULL)
+        return;
+
+    if (visible)
+        sprite_unhide(blind_select_tokens[type], 0);
+    else
+        sprite_hide(blind_select_tokens[type]);
+}
+
+static void blind_select_token_set_pos(enum BlindType type, int x, int y)
+{
+    if (blind_select_tokens[type] != NULL)
+        sprite_position(blind_select_tokens[type], x, y);
+}
+
+static void blind_select_token_move_y(enum BlindType type, int dy)
+{
+    if (blind_select_tokens[type] != NULL)
+        sprite_position(blind_select_tokens[type], blind_select_tokens[type]->pos.x, blind_select_tokens[type]->pos.y + dy);
+}
+
 void change_background(int id)
 {
     if (background == id)
@@ -595,8 +649,8 @@ void change_background(int id)
             
             // Load the tiles and palette
             // Background
-            GRIT_CPY(pal_bg_mem, background_gfxPal);
-            GRIT_CPY(&tile8_mem[MAIN_BG_CBB], background_gfxTiles); 
+            VRAM_QUEUE_GRIT_CPY(pal_bg_mem, background_gfxPal);
+            bg_assets_show(BG_ASSET_GAME);
             GRIT_CPY(&se_mem[MAIN_BG_SBB], background_gfxMap);
 
             if (current_blind == BLIND_TYPE_BIG) // Change text and palette depending on blind type
@@ -613,13 +667,13 @@ void change_background(int id)
             bg_copy_current_item_to_top_left_panel();
 
             // This would change the palette of the background to match the blind, but the backgroun doesn't use the blind token's exact colors so a different approach is required
-            memset16(&pal_bg_mem[BLIND_BG_PRIMARY_PID], blind_get_color(current_blind, BLIND_BACKGROUND_MAIN_COLOR_INDEX), 1);
-            memset16(&pal_bg_mem[BLIND_BG_SECONDARY_PID], blind_get_color(current_blind, BLIND_BACKGROUND_SECONDARY_COLOR_INDEX), 1);
-            memset16(&pal_bg_mem[BLIND_BG_SHADOW_PID], blind_get_color(current_blind, BLIND_BACKGROUND_SHADOW_COLOR_INDEX), 1);
+            vram_queue_fill16(&pal_bg_mem[BLIND_BG_PRIMARY_PID], blind_get_color(current_blind, BLIND_BACKGROUND_MAIN_COLOR_INDEX), 1);
+            vram_queue_fill16(&pal_bg_mem[BLIND_BG_SECONDARY_PID], blind_get_color(current_blind, BLIND_BACKGROUND_SECONDARY_COLOR_INDEX), 1);
+            vram_queue_fill16(&pal_bg_mem[BLIND_BG_SHADOW_PID], blind_get_color(current_blind, BLIND_BACKGROUND_SHADOW_COLOR_INDEX), 1);
 
             // Copy the Play Hand and Discard button colors to their selection highlights
-            memcpy16(&pal_bg_mem[PLAY_HAND_BTN_SELECTED_BORDER_PID], &pal_bg_mem[PLAY_HAND_BTN_PID], 1);
-            memcpy16(&pal_bg_mem[DISCARD_BTN_SELECTED_BORDER_PID], &pal_bg_mem[DISCARD_BTN_PID], 1);
+            vram_queue_copy16(&pal_bg_mem[PLAY_HAND_BTN_SELECTED_BORDER_PID], &pal_bg_mem[PLAY_HAND_BTN_PID], 1);
+            vram_queue_copy16(&pal_bg_mem[DISCARD_BTN_SELECTED_BORDER_PID], &pal_bg_mem[DISCARD_BTN_PID], 1);
         }
     }
     else if (id == BG_ID_CARD_PLAYING)
@@ -657,53 +711,54 @@ void change_background(int id)
     {
         toggle_windows(false, true);
 
-        GRIT_CPY(pal_bg_mem, background_shop_gfxPal);
-        GRIT_CPY(&tile_mem[MAIN_BG_CBB], background_shop_gfxTiles);
+        VRAM_QUEUE_GRIT_CPY(pal_bg_mem, background_shop_gfxPal);
+        bg_assets_show(BG_ASSET_SHOP);
         GRIT_CPY(&se_mem[MAIN_BG_SBB], background_shop_gfxMap);
 
         // Set the outline colors for the shop background. This is used for the alternate shop palettes when opening packs
-        memset16(&pal_bg_mem[SHOP_BOTTOM_PANEL_BORDER_PID], 0x213D, 1);
-        memset16(&pal_bg_mem[SHOP_PANEL_SHADOW_PID], 0x10B4, 1);
+        vram_queue_fill16(&pal_bg_mem[SHOP_BOTTOM_PANEL_BORDER_PID], 0x213D, 1);
+        vram_queue_fill16(&pal_bg_mem[SHOP_PANEL_SHADOW_PID], 0x10B4, 1);
         
-        memset16(&pal_bg_mem[SHOP_LIGHTS_2_PID], SHOP_LIGHTS_2_CLR, 1); // Reset the shop lights to correct colors
-        memset16(&pal_bg_mem[SHOP_LIGHTS_3_PID], SHOP_LIGHTS_3_CLR, 1);
-        memset16(&pal_bg_mem[SHOP_LIGHTS_4_PID], SHOP_LIGHTS_4_CLR, 1);
-        memset16(&pal_bg_mem[SHOP_LIGHTS_1_PID], SHOP_LIGHTS_1_CLR, 1);
+        vram_queue_fill16(&pal_bg_mem[SHOP_LIGHTS_2_PID], SHOP_LIGHTS_2_CLR, 1); // Reset the shop lights to correct colors
+        vram_queue_fill16(&pal_bg_mem[SHOP_LIGHTS_3_PID], SHOP_LIGHTS_3_CLR, 1);
+        vram_queue_fill16(&pal_bg_mem[SHOP_LIGHTS_4_PID], SHOP_LIGHTS_4_CLR, 1);
+        vram_queue_fill16(&pal_bg_mem[SHOP_LIGHTS_1_PID], SHOP_LIGHTS_1_CLR, 1);
+        shop_lights_phase = 0;
 
-        memcpy16(&pal_bg_mem[REROLL_BTN_SELECTED_BORDER_PID], &pal_bg_mem[REROLL_BTN_PID], 1); // Disable the button highlight colors
-        memcpy16(&pal_bg_mem[NEXT_ROUND_BTN_SELECTED_BORDER_PID], &pal_bg_mem[NEXT_ROUND_BTN_PID], 1); 
+        vram_queue_copy16(&pal_bg_mem[REROLL_BTN_SELECTED_BORDER_PID], &pal_bg_mem[REROLL_BTN_PID], 1); // Disable the button highlight colors
+        vram_queue_copy16(&pal_bg_mem[NEXT_ROUND_BTN_SELECTED_BORDER_PID], &pal_bg_mem[NEXT_ROUND_BTN_PID], 1); 
     }
     else if (id == BG_ID_BLIND_SELECT)
     {
         for(int i = 0; i < BLIND_TYPE_MAX; i++)
         {
-            obj_unhide(blind_select_tokens[i]->obj, 0);
+            blind_select_token_set_visible(i, true);
         }
 
         const int default_y = 89 + (TILE_SIZE * 12); // Default y position for the blind select tokens. 12 is the amound of tiles the background is shifted down by
         // TODO refactor magic numbers '80/120/160' into a map to loop with
-        sprite_position(blind_select_tokens[BLIND_TYPE_SMALL], 80, default_y);
-        sprite_position(blind_select_tokens[BLIND_TYPE_BIG], 120, default_y);
-        sprite_position(blind_select_tokens[BLIND_TYPE_BOSS], 160, default_y);
+        blind_select_token_set_pos(BLIND_TYPE_SMALL, 80, default_y);
+        blind_select_token_set_pos(BLIND_TYPE_BIG, 120, default_y);
+        blind_select_token_set_pos(BLIND_TYPE_BOSS, 160, default_y);
 
         toggle_windows(false, true);
 
-        GRIT_CPY(pal_bg_mem, background_blind_select_gfxPal);
-        GRIT_CPY(&tile_mem[MAIN_BG_CBB], background_blind_select_gfxTiles);
+        VRAM_QUEUE_GRIT_CPY(pal_bg_mem, background_blind_select_gfxPal);
+        bg_assets_show(BG_ASSET_BLIND_SELECT);
         GRIT_CPY(&se_mem[MAIN_BG_SBB], background_blind_select_gfxMap);
 
         // Copy boss blind colors to blind select palette
-        memset16(&pal_bg_mem[1], blind_get_color(BLIND_TYPE_BOSS, BLIND_BACKGROUND_MAIN_COLOR_INDEX), 1);
-        memset16(&pal_bg_mem[7], blind_get_color(BLIND_TYPE_BOSS, BLIND_BACKGROUND_SHADOW_COLOR_INDEX), 1);
+        vram_queue_fill16(&pal_bg_mem[1], blind_get_color(BLIND_TYPE_BOSS, BLIND_BACKGROUND_MAIN_COLOR_INDEX), 1);
+        vram_queue_fill16(&pal_bg_mem[7], blind_get_color(BLIND_TYPE_BOSS, BLIND_BACKGROUND_SHADOW_COLOR_INDEX), 1);
 
         // Disable the button highlight colors
         // Select button PID is 15 and the outline is 18
-        memcpy16(&pal_bg_mem[BLIND_SELECT_BTN_SELECTED_BORDER_PID], &pal_bg_mem[BLIND_SELECT_BTN_PID], 1);
+        vram_queue_copy16(&pal_bg_mem[BLIND_SELECT_BTN_SELECTED_BORDER_PID], &pal_bg_mem[BLIND_SELECT_BTN_PID], 1);
 		// It seems the skip button (and score multiplier and deck) PB idx is
 		// actually 5, not 10. 10 is the selected border color
 		// Setting this palette value though doesn't seem to have an 
 		// effect.
-        memcpy16(&pal_bg_mem[BLIND_SKIP_BTN_SELECTED_BORDER_PID], &pal_bg_mem[BLIND_SKIP_BTN_PID], 1);
+        vram_queue_copy16(&pal_bg_mem[BLIND_SKIP_BTN_SELECTED_BORDER_PID], &pal_bg_mem[BLIND_SKIP_BTN_PID], 1);
 
         for (int i = 0; i < BLIND_TYPE_MAX; i++)
         {
@@ -757,7 +812,7 @@ void change_background(int id)
                     BG_POINT gap_fill_point = {x_to, y_to};
                     main_bg_se_copy_rect(gap_fill_rect, gap_fill_point);
 
-                    sprite_position(blind_select_tokens[i], blind_select_tokens[i]->pos.x, blind_select_tokens[i]->pos.y - TILE_SIZE); // Move token up by a tile
+                    blind_select_token_move_y(i, -TILE_SIZE); // Move token up by a tile
                     break;
                 }
                 case BLIND_STATE_UPCOMING: // Change the select icon to "NEXT" 
@@ -803,12 +858,12 @@ void change_background(int id)
         toggle_windows(false, false);
 
         tte_erase_screen();
-        GRIT_CPY(pal_bg_mem, background_main_menu_gfxPal);
-        GRIT_CPY(&tile_mem[MAIN_BG_CBB], background_main_menu_gfxTiles);
+        VRAM_QUEUE_GRIT_CPY(pal_bg_mem, background_main_menu_gfxPal);
+        bg_assets_show(BG_ASSET_MAIN_MENU);
         GRIT_CPY(&se_mem[MAIN_BG_SBB], background_main_menu_gfxMap);
 
         // Disable the button highlight colors
-        memcpy16(&pal_bg_mem[MAIN_MENU_PLAY_BUTTON_OUTLINE_PID], &pal_bg_mem[MAIN_MENU_PLAY_BUTTON_MAIN_COLOR_PID], 1);
+        vram_queue_copy16(&pal_bg_mem[MAIN_MENU_PLAY_BUTTON_OUTLINE_PID], &pal_bg_mem[MAIN_MENU_PLAY_BUTTON_MAIN_COLOR_PID], 1);
     }
     else
     {
@@ -820,59 +875,27 @@ void change_background(int id)
 
 void display_temp_score(int value)
 {
-    int x_offset = 40 - get_digits_even(value) * TILE_SIZE;
-    tte_erase_rect_wrapper(TEMP_SCORE_RECT);
-    tte_printf("#{P:%d,%d; cx:0x%X000}%d", x_offset, TEMP_SCORE_RECT.top, TTE_WHITE_PB, value);
+    counter_draw(&TEMP_SCORE_COUNTER, value);
 }
 
 void display_score(int value)
 {
-    // Clear the existing text before redrawing
-    tte_erase_rect_wrapper(SCORE_RECT);
-    
-    char score_suffix = ' ';
-    int display_value = value;
-    
-    if(value >= TEN_K)
-    {
-        score_suffix = 'k';
-        display_value = value / ONE_K; // 12,986 = 12k
-    }
-    
-    // Calculate text width: digits + suffix character (if 'k')
-    int num_digits = get_digits(display_value);
-    int text_width = num_digits * TILE_SIZE;
-    if(score_suffix == 'k')
-    {
-        text_width += TILE_SIZE; // Add width for 'k' suffix
-    }
-    
-    // Calculate center position within SCORE_RECT
-    int rect_width = SCORE_RECT.right - SCORE_RECT.left;
-    int x_offset = SCORE_RECT.left + (rect_width - text_width) / 2;
-    
-    tte_printf("#{P:%d,48; cx:0x%X000}%d%c", x_offset, TTE_WHITE_PB, display_value, score_suffix);
+    counter_draw(&SCORE_COUNTER, value); // 12,986 = 12k
 }
 
 void display_money(int value)
 {
-    int x_offset = 32 - get_digits_odd(value) * TILE_SIZE;
-    tte_erase_rect_wrapper(MONEY_TEXT_RECT);
-    tte_printf("#{P:%d,%d; cx:0x%X000}$%d", x_offset, MONEY_TEXT_RECT.top, TTE_YELLOW_PB, value);
+    counter_draw(&MONEY_COUNTER, value);
 }
 
 void display_chips(int value)
 {
-    Rect chips_text_rect = CHIPS_TEXT_RECT;
-    tte_erase_rect_wrapper(CHIPS_TEXT_RECT);
-    update_text_rect_to_right_align_num(&chips_text_rect, value, OVERFLOW_LEFT);
-    tte_printf("#{P:%d,%d; cx:0x%X000;}%d", chips_text_rect.left, chips_text_rect.top, TTE_WHITE_PB, value);
+    counter_draw(&CHIPS_COUNTER, value);
 }
 
 void display_mult(int value)
 {
-    tte_erase_rect_wrapper(MULT_TEXT_RECT);
-    tte_printf("#{P:%d,%d; cx:0x%X000;}%d", MULT_TEXT_RECT.left, MULT_TEXT_RECT.top, TTE_WHITE_PB, value); // Mult
+    counter_draw(&MULT_COUNTER, value);
 }
 
 void display_round(int value)
@@ -905,82 +928,39 @@ static void print_hand_type(const char* hand_type_str)
     tte_printf("#{P:%d,%d; cx:0x%X000}%s", HAND_TYPE_RECT.left, HAND_TYPE_RECT.top, TTE_WHITE_PB, hand_type_str);
 }
 
+// Indexed by enum HandType
+static const HandTypeInfo HAND_TYPE_INFO[] =
+{
+    [NONE]              = { NULL,       0,   0  },
+    [HIGH_CARD]         = { "HIGH C",   5,   1  },
+    [PAIR]              = { "PAIR",     10,  2  },
+    [TWO_PAIR]          = { "2 PAIR",   20,  2  },
+    [THREE_OF_A_KIND]   = { "3 OAK",    30,  3  },
+    [FOUR_OF_A_KIND]    = { "4 OAK",    60,  7  },
+    [STRAIGHT]          = { "STRT",     30,  4  },
+    [FLUSH]             = { "FLUSH",    35,  4  },
+    [FULL_HOUSE]        = { "FULL H",   40,  4  },
+    [STRAIGHT_FLUSH]    = { "STRT F",   100, 8  },
+    [ROYAL_FLUSH]       = { "ROYAL F",  100, 8  },
+    [FIVE_OF_A_KIND]    = { "5 OAK",    120, 12 },
+    [FLUSH_HOUSE]       = { "FLUSH H",  140, 14 },
+    [FLUSH_FIVE]        = { "FLUSH 5",  160, 16 },
+};
+
+const HandTypeInfo *hand_type_get_info(enum HandType hand_type)
+{
+    return &HAND_TYPE_INFO[hand_type];
+}
+
 void set_hand()
 {
     tte_erase_rect_wrapper(HAND_TYPE_RECT);
     hand_type = hand_get_type();
-    switch (hand_type)
-    {
-    case HIGH_CARD:
-        print_hand_type("HIGH C");
-        chips = 5;
-        mult = 1;
-        break;
-    case PAIR:
-        print_hand_type("PAIR");
-        chips = 10;
-        mult = 2;
-        break;
-    case TWO_PAIR:
-        print_hand_type("2 PAIR");
-        chips = 20;
-        mult = 2;
-        break;
-    case THREE_OF_A_KIND:
-        print_hand_type("3 OAK");
-        chips = 30;
-        mult = 3;
-        break;
-    case STRAIGHT:
-        print_hand_type("STRT");
-        chips = 30;
-        mult = 4;
-        break;
-    case FLUSH:
-        print_hand_type("FLUSH");
-        chips = 35;
-        mult = 4;
-        break;
-    case FULL_HOUSE:
-        print_hand_type("FULL H");
-        chips = 40;
-        mult = 4;
-        break;
-    case FOUR_OF_A_KIND:
-        print_hand_type("4 OAK");
-        chips = 60;
-        mult = 7;
-        break;
-    case STRAIGHT_FLUSH:
-        print_hand_type("STRT F");
-        chips = 100;
-        mult = 8;
-        break;
-    case ROYAL_FLUSH:
-        print_hand_type("ROYAL F");
-        chips = 100;
-        mult = 8;
-        break;
-    case FIVE_OF_A_KIND:
-        print_hand_type("5 OAK");
-        chips = 120;
-        mult = 12;
-        break;
-    case FLUSH_HOUSE:
-        print_hand_type("FLUSH H");
-        chips = 140;
-        mult = 14;
-        break;
-    case FLUSH_FIVE:
-        print_hand_type("FLUSH 5");
-        chips = 160;
-        mult = 16;
-        break;
-    case NONE:
-        chips = 0;
-        mult = 0;
-        break;
-    }
+
+    const HandTypeInfo *info = hand_type_get_info(hand_type);
+    print_hand_type(info->name);
+    chips = info->base_chips;
+    mult = info->base_mult;
 
     display_chips(chips);
     display_mult(mult);
@@ -990,7 +970,7 @@ void card_draw()
 {
     if (deck_top < 0 || hand_top >= hand_size - 1 || hand_top >= MAX_HAND_SIZE - 1) return;
 
-    CardObject *card_object = card_object_new(deck_pop());
+    CardObject *card_object = card_object_new(card_new_from_code(deck_pop()));
 
     const FIXED deck_x = int2fx(CARD_DRAW_POS.x);
     const FIXED deck_y = int2fx(CARD_DRAW_POS.y);
@@ -1024,7 +1004,7 @@ void hand_set_focus(int index)
         selection_x = index;
     }
 
-    play_sfx(SFX_CARD_FOCUS, MM_BASE_PITCH_RATE + rand() % 512);
+    play_sfx(SFX_CARD_FOCUS, MM_BASE_PITCH_RATE + rng_range(RNG_COSMETIC, 512));
 }
 
 void hand_toggle_card_selection()
@@ -1101,8 +1081,8 @@ void deck_shuffle()
 {
     for (int i = deck_top; i > 0; i--) 
     {
-        int j = rand() % (i + 1);
-        Card *temp = deck[i];
+        int j = rng_range(RNG_DECK, i + 1);
+        CardCode temp = deck[i];
         deck[i] = deck[j];
         deck[j] = temp;
     }
@@ -1141,7 +1121,7 @@ static void game_round_init()
 
     if (round_end_blind_token != NULL)
     {
-        obj_hide(round_end_blind_token->obj); // Hide the blind token sprite for now
+        sprite_hide(round_end_blind_token); // Hide the blind token sprite for now
     }
 
     Rect blind_req_text_rect = BLIND_REQ_TEXT_RECT;
@@ -1179,8 +1159,11 @@ static void game_main_menu_init()
     affine_background_change_background(AFFINE_BG_MAIN_MENU);
     change_background(BG_ID_MAIN_MENU);
     main_menu_ace = card_object_new(card_new(SPADES, ACE));
-    card_object_set_sprite(main_menu_ace, 0); // Set the sprite for the ace of spades
-    main_menu_ace->sprite_object->sprite->obj->attr0 |= ATTR0_AFF_DBL; // Make the sprite double sized
+    if (card_object_set_sprite(main_menu_ace, 0)) // Set the sprite for the ace of spades
+    {
+        main_menu_ace->sprite_object->sprite->obj->attr0 |= ATTR0_AFF_DBL; // Make the sprite double sized
+        sprite_mark_dirty(main_menu_ace->sprite_object->sprite);
+    }
     main_menu_ace->sprite_object->tx = int2fx(MAIN_MENU_ACE_T.x);
     main_menu_ace->sprite_object->x = main_menu_ace->sprite_object->tx;
     main_menu_ace->sprite_object->ty = int2fx(MAIN_MENU_ACE_T.y);
@@ -1197,6 +1180,7 @@ static void game_over_init()
 
 static void game_lose_init()
 {
+    save_erase(); // The run is over, there's nothing to continue
     game_over_init();
     // Using the text color to match the "Game Over" text
     affine_background_set_color(TEXT_CLR_RED);
@@ -1205,6 +1189,7 @@ static void game_lose_init()
 
 static void game_win_init()
 {
+    save_erase();
     game_over_init();
     // Using the text color to match the "You Win" text
     affine_background_set_color(TEXT_CLR_BLUE);
@@ -1251,25 +1236,210 @@ void game_set_state(enum GameState new_game_state)
 
 void jokers_available_to_shop_init()
 {
-    int num_defined_jokers = get_joker_registry_size();
-    jokers_available_to_shop = list_new(num_defined_jokers);
-    for (intptr_t i = 0; i < num_defined_jokers; i++)
+    joker_id_list_clear(&jokers_available_to_shop);
+    for (int i = 0; i < NUM_JOKERS; i++)
     {
         // Add all joker IDs sequentially
-        int_list_append(jokers_available_to_shop, i);
+        joker_id_list_append(&jokers_available_to_shop, i);
     }
 }
 
+// Shows the run's counters and goes to first_state, for a new run as well as a continued one
+static void game_run_begin(enum GameState first_state)
+{
+    affine_background_change_background(AFFINE_BG_GAME);
+
+    // Normally I would just cache these and hide/unhide but I didn't feel like dealing with defining a layer for it
+    card_object_destroy(&main_menu_ace);
+
+    change_background(first_state == GAME_SHOP ? BG_ID_SHOP : BG_ID_BLIND_SELECT);
+
+    tte_printf("#{P:%d,%d; cx:0x%X000}%d/%d", DECK_SIZE_RECT.left, DECK_SIZE_RECT.top, TTE_WHITE_PB, deck_get_size(), deck_get_max_size()); // Deck size/max size
+    
+    display_round(round); // Set the round display
+    display_score(score); // Set the score display
+
+    display_chips(chips); // Set the chips display
+    display_mult(mult); // Set the multiplier display
+
+    display_hands(hands); // Hand
+    display_discards(discards); // Discard
+
+    display_money(money); // Set the money display
+
+    tte_printf("#{P:%d,%d; cx:0x%X000}%d#{cx:0x%X000}/%d", ANTE_TEXT_RECT.left, ANTE_TEXT_RECT.top, TTE_YELLOW_PB, ante, TTE_WHITE_PB, MAX_ANTE); // Ante
+
+    game_set_state(first_state);
+}
+
+// Run save, see save.h
+
+#define RUN_SAVE_VERSION 1 // Bump when RunSave changes, older saves are then ignored
+
+/* What a run is between rounds, the hand and the played cards are always empty there.
+ * Small fields that change every round come first, so a save's changed bytes are mostly in one record.
+ */
+typedef struct
+{
+    u8 resume_state; // The GameState the run continues in
+    u8 current_blind;
+    u8 blinds[BLIND_TYPE_MAX];
+    u8 ante;
+    u8 max_hands;
+    u8 max_discards;
+    u8 hands;
+    u8 discards;
+    u8 hand_size;
+    u8 sort_by_suit;
+    u8 num_jokers;
+    u8 num_jokers_available;
+    u16 round;
+    u16 deck_size;
+    u16 discard_size;
+    s32 money;
+    s32 score;
+    u32 seed;
+    u32 rng_states[RNG_NUM_STREAMS];
+    u8 joker_ids[MAX_JOKERS_HELD_SIZE];
+    u8 joker_modifiers[MAX_JOKERS_HELD_SIZE];
+    u8 joker_values[MAX_JOKERS_HELD_SIZE];
+    u8 jokers_available[NUM_JOKERS];
+    CardCode cards[MAX_DECK_SIZE]; // The deck from the bottom, then the discard pile
+} RunSave;
+
+_Static_assert(sizeof(RunSave) <= SAVE_MAX_SIZE, "RunSave doesn't fit in a save slot");
+
+static EWRAM_BSS RunSave run_save;
+
+// Saves the run so that continuing it goes to resume_state, call only between rounds
+static void game_save(enum GameState resume_state)
+{
+    // Unused bytes and padding are zeroed too, or they'd show up as changes
+    memset(&run_save, 0, sizeof(run_save));
+
+    run_save.resume_state = resume_state;
+    run_save.current_blind = current_blind;
+    for (int i = 0; i < BLIND_TYPE_MAX; i++)
+    {
+        run_save.blinds[i] = blinds[i];
+    }
+    run_save.ante = ante;
+    run_save.max_hands = max_hands;
+    run_save.max_discards = max_discards;
+    run_save.hands = hands;
+    run_save.discards = discards;
+    run_save.hand_size = hand_size;
+    run_save.sort_by_suit = sort_by_suit;
+    run_save.round = round;
+    run_save.money = money;
+    run_save.score = score;
+
+    run_save.seed = rng_seed;
+    for (int i = 0; i < RNG_NUM_STREAMS; i++)
+    {
+        run_save.rng_states[i] = rng_get_state(i);
+    }
+
+    run_save.num_jokers = jokers.size;
+    for (int i = 0; i < jokers.size; i++)
+    {
+        const Joker *joker = jokers.items[i]->joker;
+        run_save.joker_ids[i] = joker->id;
+        run_save.joker_modifiers[i] = joker->modifier;
+        run_save.joker_values[i] = joker->value;
+    }
+
+    run_save.num_jokers_available = jokers_available_to_shop.size;
+    for (int i = 0; i < jokers_available_to_shop.size; i++)
+    {
+        run_save.jokers_available[i] = jokers_available_to_shop.items[i];
+    }
+
+    run_save.deck_size = deck_top + 1;
+    run_save.discard_size = discard_top + 1;
+    memcpy(run_save.cards, deck, run_save.deck_size * sizeof(CardCode));
+    memcpy(&run_save.cards[run_save.deck_size], discard_pile, run_save.discard_size * sizeof(CardCode));
+
+    save_write(&run_save);
+}
+
+// Continues the saved run from the main menu, all in this frame
+static void game_continue(void)
+{
+    if (!save_load(&run_save))
+        return;
+
+    set_seed(run_save.seed);
+    for (int i = 0; i < RNG_NUM_STREAMS; i++)
+    {
+        rng_set_state(i, run_save.rng_states[i]);
+    }
+
+    current_blind = run_save.current_blind;
+    for (int i = 0; i < BLIND_TYPE_MAX; i++)
+    {
+        blinds[i] = run_save.blinds[i];
+    }
+    ante = run_save.ante;
+    max_hands = run_save.max_hands;
+    max_discards = run_save.max_discards;
+    hands = run_save.hands;
+    discards = run_save.discards;
+    hand_size = run_save.hand_size;
+    sort_by_suit = run_save.sort_by_suit;
+    round = run_save.round;
+    money = run_save.money;
+    score = run_save.score;
+
+    for (int i = 0; i < run_save.num_jokers; i++)
+    {
+        Joker *joker = joker_new(run_save.joker_ids[i]);
+        joker->modifier = run_save.joker_modifiers[i];
+        joker->value = run_save.joker_values[i];
+
+        JokerObject *joker_object = joker_object_new(joker);
+        if (joker_object == NULL)
+        {
+            joker_destroy(&joker);
+            continue;
+        }
+
+        joker_object->sprite_object->x = int2fx(HELD_JOKERS_POS.x);
+        joker_object->sprite_object->y = int2fx(HELD_JOKERS_POS.y);
+        joker_object->sprite_object->tx = joker_object->sprite_object->x;
+        joker_object->sprite_object->ty = joker_object->sprite_object->y;
+        sprite_position(joker_object_get_sprite(joker_object), HELD_JOKERS_POS.x, HELD_JOKERS_POS.y);
+        add_joker(joker_object);
+    }
+
+    joker_id_list_clear(&jokers_available_to_shop);
+    for (int i = 0; i < run_save.num_jokers_available; i++)
+    {
+        joker_id_list_append(&jokers_available_to_shop, run_save.jokers_available[i]);
+    }
+
+    for (int i = 0; i < run_save.deck_size; i++)
+    {
+        deck_push(run_save.cards[i]);
+    }
+    for (int i = 0; i < run_save.discard_size; i++)
+    {
+        discard_push(run_save.cards[run_save.deck_size + i]);
+    }
+
+    game_run_begin(run_save.resume_state);
+}
+
 void game_init()
 {
     jokers_available_to_shop_init();
+    save_init(RUN_SAVE_VERSION, sizeof(RunSave));
 
     // Initialize jokers list
-    if (jokers) list_destroy(&jokers);
-    jokers = list_new(MAX_JOKERS_HELD_SIZE);
+    joker_object_list_clear(&jokers);
+    joker_dispatch_rebuild();
 
-    if (discarded_jokers != NULL) list_destroy(&discarded_jokers);
-    discarded_jokers = list_new(MAX_JOKERS_HELD_SIZE);
+    joker_object_list_clear(&discarded_jokers);
 
     hands = max_hands;
     discards = max_discards;
@@ -1278,9 +1448,9 @@ void game_init()
     blind_select_tokens[BLIND_TYPE_BIG] = blind_token_new(BLIND_TYPE_BIG, CUR_BLIND_TOKEN_POS.x, CUR_BLIND_TOKEN_POS.y, MAX_SELECTION_SIZE + MAX_HAND_SIZE + 4);
     blind_select_tokens[BLIND_TYPE_BOSS] = blind_token_new(BLIND_TYPE_BOSS, CUR_BLIND_TOKEN_POS.x, CUR_BLIND_TOKEN_POS.y, MAX_SELECTION_SIZE + MAX_HAND_SIZE + 5);
 
-    obj_hide(blind_select_tokens[BLIND_TYPE_SMALL]->obj);
-    obj_hide(blind_select_tokens[BLIND_TYPE_BIG]->obj);
-    obj_hide(blind_select_tokens[BLIND_TYPE_BOSS]->obj);
+    blind_select_token_set_visible(BLIND_TYPE_SMALL, false);
+    blind_select_token_set_visible(BLIND_TYPE_BIG, false);
+    blind_select_token_set_visible(BLIND_TYPE_BOSS, false);
 
     game_set_state(game_state);
 }
@@ -1289,12 +1459,6 @@ void game_start()
 {
     set_seed(rng_seed);
 
-    affine_background_change_background(AFFINE_BG_GAME);
-
-    // Normally I would just cache these and hide/unhide but I didn't feel like dealing with defining a layer for it
-    card_destroy(&main_menu_ace->card);
-    card_object_destroy(&main_menu_ace);
-
     hands = max_hands;
     discards = max_discards;
 
@@ -1303,29 +1467,89 @@ void game_start()
     {
         for (int rank = 0; rank < NUM_RANKS; rank++)
         {
-            Card *card = card_new(suit, rank);
-            deck_push(card);
+            deck_push(card_code_make(suit, rank));
         }
     }
 
-    change_background(BG_ID_BLIND_SELECT);
+    game_run_begin(GAME_BLIND_SELECT);
+    game_save(GAME_BLIND_SELECT);
+}
 
-    tte_printf("#{P:%d,%d; cx:0x%X000}%d/%d", DECK_SIZE_RECT.left, DECK_SIZE_RECT.top, TTE_WHITE_PB, deck_get_size(), deck_get_max_size()); // Deck size/max size
-    
-    display_round(round); // Set the round display
-    display_score(score); // Set the score display
+// Best play hint, searched in the time left over at the end of frames while selecting cards
+static Solver hint_solver;
+static bool hint_solver_started = false;
+static bool hint_shown = false;
 
-    display_chips(chips); // Set the chips display
-    display_mult(mult); // Set the multiplier display
+static void hint_reset(void)
+{
+    if (hint_shown)
+    {
+        tte_erase_rect_wrapper(PLAYED_CARDS_SCORES_RECT);
+        hint_shown = false;
+    }
+    hint_solver_started = false;
+}
 
-    display_hands(hands); // Hand
-    display_discards(discards); // Discard
+static void hint_start(void)
+{
+    Card *hand_cards[MAX_HAND_SIZE];
+    for (int i = 0; i <= hand_top; i++)
+    {
+        hand_cards[i] = hand[i]->card;
+    }
 
-    display_money(money); // Set the money display
+    hint_reset();
+    solver_start(&hint_solver, hand_cards, hand_top + 1, &joker_dispatch);
+    hint_solver_started = true;
+}
 
-    tte_printf("#{P:%d,%d; cx:0x%X000}%d#{cx:0x%X000}/%d", ANTE_TEXT_RECT.left, ANTE_TEXT_RECT.top, TTE_YELLOW_PB, ante, TTE_WHITE_PB, MAX_ANTE); // Ante
+// Start over for a new hand or if jokers were sold meanwhile
+static bool hint_is_stale(void)
+{
+    return !hint_solver_started || hint_solver.jokers.num_jokers != jokers.size;
+}
 
-    game_set_state(GAME_BLIND_SELECT);
+static void hint_show(void)
+{
+    const HandTypeInfo *info = hand_type_get_info(hint_solver.best_hand_type);
+    tte_erase_rect_wrapper(PLAYED_CARDS_SCORES_RECT);
+    tte_printf("#{P:%d,%d; cx:0x%X000}BEST %s %d", PLAYED_CARDS_SCORES_RECT.left, PLAYED_CARDS_SCORES_RECT.top,
+               TTE_WHITE_PB, info->name, hint_solver.best_score);
+    hint_shown = true;
+}
+
+// Selects the cards of the best play, the hand may have been sorted since the search started
+static void hint_apply(void)
+{
+    // Finished here instead of waiting for idle time, so the same inputs always select the same cards
+    if (hint_is_stale())
+    {
+        hint_start();
+    }
+
+    solver_solve(&hint_solver);
+
+    for (int i = 0; i <= hand_top; i++)
+    {
+        bool in_best_play = false;
+        for (int j = 0; j < hint_solver.hand_size; j++)
+        {
+            if (hint_solver.hand[j] == hand[i]->card && solver_best_play_contains(&hint_solver, j))
+            {
+                in_best_play = true;
+                break;
+            }
+        }
+
+        if (card_object_is_selected(hand[i]) != in_best_play)
+        {
+            card_object_set_selected(hand[i], in_best_play);
+            hand_selections += in_best_play ? 1 : -1;
+        }
+    }
+
+    play_sfx(SFX_CARD_SELECT, MM_BASE_PITCH_RATE);
+    set_hand();
 }
 
 static void game_playing_process_hand_select_input()
@@ -1375,8 +1599,8 @@ static void game_playing_process_hand_select_input()
     {
         if (discard_button_highlighted == false) // Play button logic
         {
-            memset16(&pal_bg_mem[PLAY_HAND_BTN_SELECTED_BORDER_PID], HIGHLIGHT_COLOR, 1);
-            memcpy16(&pal_bg_mem[DISCARD_BTN_SELECTED_BORDER_PID], &pal_bg_mem[DISCARD_BTN_PID], 1);
+            vram_queue_fill16(&pal_bg_mem[PLAY_HAND_BTN_SELECTED_BORDER_PID], HIGHLIGHT_COLOR, 1);
+            vram_queue_copy16(&pal_bg_mem[DISCARD_BTN_SELECTED_BORDER_PID], &pal_bg_mem[DISCARD_BTN_PID], 1);
 
             if (key_hit(SELECT_CARD) && hands > 0 && hand_play())
             {
@@ -1389,8 +1613,8 @@ static void game_playing_process_hand_select_input()
         else // Discard button logic
         {
 			// 7 is score and play hand button color
-            memcpy16(&pal_bg_mem[PLAY_HAND_BTN_SELECTED_BORDER_PID], &pal_bg_mem[PLAY_HAND_BTN_PID], 1);
-            memset16(&pal_bg_mem[DISCARD_BTN_SELECTED_BORDER_PID], HIGHLIGHT_COLOR, 1);
+            vram_queue_copy16(&pal_bg_mem[PLAY_HAND_BTN_SELECTED_BORDER_PID], &pal_bg_mem[PLAY_HAND_BTN_PID], 1);
+            vram_queue_fill16(&pal_bg_mem[DISCARD_BTN_SELECTED_BORDER_PID], HIGHLIGHT_COLOR, 1);
 
             if (key_hit(SELECT_CARD) && discards > 0 && hand_discard())
             {
@@ -1405,8 +1629,8 @@ static void game_playing_process_hand_select_input()
     }
     else if (selection_y == 0) // On row of cards
     {
-        memcpy16(&pal_bg_mem[PLAY_HAND_BTN_SELECTED_BORDER_PID], &pal_bg_mem[PLAY_HAND_BTN_PID], 1); // Play button highlight color
-        memcpy16(&pal_bg_mem[DISCARD_BTN_SELECTED_BORDER_PID], &pal_bg_mem[DISCARD_BTN_PID], 1); // Discard button highlight color
+        vram_queue_copy16(&pal_bg_mem[PLAY_HAND_BTN_SELECTED_BORDER_PID], &pal_bg_mem[PLAY_HAND_BTN_PID], 1); // Play button highlight color
+        vram_queue_copy16(&pal_bg_mem[DISCARD_BTN_SELECTED_BORDER_PID], &pal_bg_mem[DISCARD_BTN_PID], 1); // Discard button highlight color
         
         if (key_hit(SELECT_CARD))
         {
@@ -1425,6 +1649,11 @@ static void game_playing_process_hand_select_input()
     {
         hand_change_sort();
     }
+
+    if (key_hit(APPLY_HINT))
+    {
+        hint_apply();
+    }
 }
 
 static void game_playing_process_input_and_state()
@@ -1463,7 +1692,7 @@ static void game_playing_process_input_and_state()
 
             if (temp_score <= 0)
             {
-                tte_erase_rect_wrapper(TEMP_SCORE_RECT);
+                tte_erase_rect_wrapper(TEMP_SCORE_COUNTER.rect);
             }
         }
         else
@@ -1473,7 +1702,7 @@ static void game_playing_process_input_and_state()
             lerped_temp_score = 0;
             lerped_score = 0;
 
-            tte_erase_rect_wrapper(TEMP_SCORE_RECT); // Just erase the temp score
+            tte_erase_rect_wrapper(TEMP_SCORE_COUNTER.rect); // Just erase the temp score
 
             display_score(score);
         }
@@ -1538,9 +1767,9 @@ static void game_playing_discarded_cards_loop()
 
         // We take each discarded card and put it back into the deck with a short animation
         static CardObject* discarded_card_object = NULL;
-        if (discarded_card_object == NULL)
+        if (discarded_card_object == NULL && discard_top >= 0)
         {
-            discarded_card_object = card_object_new(discard_pop());
+            discarded_card_object = card_object_new(card_new_from_code(discard_pop()));
             //discarded_card_object->sprite = sprite_new(ATTR0_SQUARE | ATTR0_4BPP | ATTR0_AFF, ATTR1_SIZE_32, card_sprite_lut[discarded_card_object->card->suit][discarded_card_object->card->rank], 0, 0);
             card_object_set_sprite(discarded_card_object, 0); // Set the sprite for the discarded card object
             sprite_object_reset_transform(discarded_card_object->sprite_object);
@@ -1552,13 +1781,13 @@ static void game_playing_discarded_cards_loop()
 
             card_object_update(discarded_card_object);
         }
-        else
+        else if (discarded_card_object != NULL)
         {
             card_object_update(discarded_card_object);
 
             if (discarded_card_object->sprite_object->y >= discarded_card_object->sprite_object->ty)
             {
-                deck_push(discarded_card_object->card); // Put the card back into the deck
+                deck_push(card_get_code(discarded_card_object->card)); // Put the card back into the deck
                 card_object_destroy(&discarded_card_object);
 
                 play_sfx(SFX_CARD_DRAW, MM_BASE_PITCH_RATE + PITCH_STEP_UNDISCARD_SFX);
@@ -1599,7 +1828,7 @@ void card_in_hand_loop_handle_discard_and_shuffling(int card_idx, bool* discarde
 
             if (hand[card_idx]->sprite_object->x >= *hand_x)
             {
-                discard_push(hand[card_idx]->card);
+                discard_push(card_get_code(hand[card_idx]->card));
                 card_object_destroy(&hand[card_idx]);
                 sort_cards();
 
@@ -1608,8 +1837,11 @@ void card_in_hand_loop_handle_discard_and_shuffling(int card_idx, bool* discarde
                 *sound_played = false;
                 timer = TM_ZERO;
 
-                *hand_y = hand[card_idx]->sprite_object->y;
-                *hand_x = hand[card_idx]->sprite_object->x;
+                if (hand[card_idx] != NULL) // Unless the discarded card was the last one
+                {
+                    *hand_y = hand[card_idx]->sprite_object->y;
+                    *hand_x = hand[card_idx]->sprite_object->x;
+                }
             }
 
             *discarded_card = true;
@@ -1720,147 +1952,18 @@ static void cards_in_hand_update_loop(bool* discarded_card, int* played_selectio
                     timer = TM_ZERO;
                     *played_selections = played_top + 1;
 
-                    switch (hand_type) // select the cards that apply to the hand type
+                    // Select the cards that apply to the hand type
+                    Card *played_cards[MAX_SELECTION_SIZE];
+                    bool is_scoring[MAX_SELECTION_SIZE];
+                    for (int i = 0; i <= played_top; i++)
                     {
-                    case NONE:
-                        break;
-                    case HIGH_CARD: // find the card with the highest rank in the hand
-                        int highest_rank_index = 0;
-
-                        for (int i = 0; i <= played_top; i++)
-                        {
-                            if (played[i]->card->rank > played[highest_rank_index]->card->rank)
-                            {
-                                highest_rank_index = i;
-                            }
-                        }
-
-                        card_object_set_selected(played[highest_rank_index], true);
-                        break;
-                    case PAIR: // find two cards with the same rank (Requires recursion)
-                        for (int i = 0; i <= played_top - 1; i++)
-                        {
-                            for (int j = i + 1; j <= played_top; j++)
-                            {
-                                if (played[i]->card->rank == played[j]->card->rank)
-                                {
-                                    card_object_set_selected(played[i], true);
-                                    card_object_set_selected(played[j], true);
-                                    break;
-                                }
-                            }
-
-                            if (card_object_is_selected(played[i])) break;
-                        }
-                        break;
-                    case TWO_PAIR: // find two pairs of cards with the same rank (Requires recursion)
-                        int i;
-
-                        for (i = 0; i <= played_top - 1; i++)
-                        {
-                            for (int j = i + 1; j <= played_top; j++)
-                            {
-                                if (played[i]->card->rank == played[j]->card->rank)
-                                {
-                                    card_object_set_selected(played[i], true);
-                                    card_object_set_selected(played[j], true);
-
-                                    break;
-                                }
-                            }
-
-                            if (card_object_is_selected(played[i])) break;
-                        }
-
-                        for (; i <= played_top - 1; i++) // Find second pair
-                        {
-                            for (int j = i + 1; j <= played_top; j++)
-                            {
-                                if (played[i]->card->rank == played[j]->card->rank && !card_object_is_selected(played[i]) && !card_object_is_selected(played[j]))
-                                {
-                                    card_object_set_selected(played[i], true);
-                                    card_object_set_selected(played[j], true);
-                                    break;
-                                }
-                            }
-                        }
-                        break;
-                    case THREE_OF_A_KIND: // find three cards with the same rank (requires recursion)
-                        for (int i = 0; i <= played_top - 1; i++)
-                        {
-                            for (int j = i + 1; j <= played_top; j++)
-                            {
-                                if (played[i]->card->rank == played[j]->card->rank)
-                                {
-                                    card_object_set_selected(played[i], true);
-                                    card_object_set_selected(played[j], true);
-
-                                    for (int k = j + 1; k <= played_top; k++)
-                                    {
-                                        if (played[i]->card->rank == played[k]->card->rank && !card_object_is_selected(played[k]))
-                                        {
-                                            card_object_set_selected(played[k], true);
-                                            break;
-                                        }
-                                    }
-
-                                    break;
-                                }
-                            }
-
-                            if (card_object_is_selected(played[i])) break;
-                        }
-                        break;
-                    case FOUR_OF_A_KIND: // find four cards with the same rank (requires recursion)
-                        if (played_top >= 3) // If there are 5 cards selected we just need to find the one card that doesn't match, and select the others
-                        {
-                            int unmatched_index = -1;
-
-                            for (int i = 0; i <= played_top; i++)
-                            {
-                                if (played[i]->card->rank != played[(i + 1) % played_top]->card->rank && played[i]->card->rank != played[(i + 2) % played_top]->card->rank)
-                                {
-                                    unmatched_index = i;
-                                    break;
-                                }
-                            }
+                        played_cards[i] = played[i]->card;
+                    }
 
-                            for (int i = 0; i <= played_top; i++)
-                            {
-                                if (i != unmatched_index)
-                                {
-                                    card_object_set_selected(played[i], true);
-                                }
-                            }
-                        }
-                        else // If there are only 4 cards selected we know they match
-                        {
-                            for (int i = 0; i <= played_top; i++)
-                            {
-                                card_object_set_selected(played[i], true);
-                            }
-                        }
-                        break;
-                    case STRAIGHT:
-                        /* FALL THROUGH */
-                    case FLUSH:
-                        /* FALL THROUGH */
-                    case FULL_HOUSE:
-                        /* FALL THROUGH */
-                    case STRAIGHT_FLUSH:
-                        /* FALL THROUGH */
-                    case ROYAL_FLUSH:
-                        /* FALL THROUGH */
-                    case FIVE_OF_A_KIND:
-                        /* FALL THROUGH */
-                    case FLUSH_HOUSE:
-                        /* FALL THROUGH */
-                    case FLUSH_FIVE: // Select all played cards in the hand (This is functionally identical as the above hand types)
-                        for (int i = 0; i <= played_top; i++)
-                        {
-                            card_object_set_selected(played[i], true);
-                        }
-                        break;
+                    hand_get_scoring_cards(played_cards, played_top + 1, hand_type, is_scoring);
+                    for (int i = 0; i <= played_top; i++)
+                    {
+                        card_object_set_selected(played[i], is_scoring[i]);
                     }
                 }
 
@@ -1871,6 +1974,8 @@ static void cards_in_hand_update_loop(bool* discarded_card, int* played_selectio
                 break;
             }
 
+            if (hand[i] == NULL) continue; // The card was just moved to the played stack
+
             hand[i]->sprite_object->tx = hand_x;
             hand[i]->sprite_object->ty = hand_y;
             card_object_update(hand[i]);
@@ -1878,6 +1983,61 @@ static void cards_in_hand_update_loop(bool* discarded_card, int* played_selectio
     }
 }
 
+// Scores the played hand all at once so the animation only has to replay the result
+static void played_hand_score(void)
+{
+    Card *scoring_cards[MAX_SELECTION_SIZE];
+    int num_scoring_cards = 0;
+    for (int i = 0; i <= played_top && num_scoring_cards < MAX_SELECTION_SIZE; i++)
+    {
+        if (played[i] != NULL && card_object_is_selected(played[i]))
+        {
+            scoring_card_played_idx[num_scoring_cards] = i;
+            scoring_cards[num_scoring_cards++] = played[i]->card;
+        }
+    }
+
+    get_played_hand_context(&hand_context, hand_type);
+    score_hand(scoring_cards, num_scoring_cards, &hand_context, &joker_dispatch, chips, mult, &score_result);
+    scoring_event_idx = 0;
+}
+
+static void scoring_event_play(const ScoringEvent *event)
+{
+    switch (event->type)
+    {
+        case SCORING_EVENT_CARD:
+        {
+            CardObject *card_object = played[scoring_card_played_idx[event->card_idx]];
+
+            // Offset of 16 pixels to center the text on the card
+            counter_draw_at(fx2int(card_object->sprite_object->x) + 8, SCORED_CARD_TEXT_Y, TTE_BLUE_PB, '+', event->effect.chips);
+
+            card_object_shake(card_object, SFX_CARD_SELECT);
+            break;
+        }
+        case SCORING_EVENT_JOKER:
+            joker_object_show_effect(jokers.items[event->joker_idx], &event->effect);
+            break;
+    }
+
+    chips = event->chips;
+    mult = event->mult;
+    money += event->effect.money;
+
+    display_chips(chips);
+    display_mult(mult);
+    display_money(money);
+}
+
+// True if the card last reached by the played selections doesn't score so it can be passed over right away.
+// Before the first card is reached there is no such card.
+static bool played_card_skippable(int played_selections)
+{
+    int idx = played_top - played_selections;
+    return idx >= 0 && idx <= played_top && !card_object_is_selected(played[idx]);
+}
+
 static void played_cards_update_loop(bool* discarded_card, int* played_selections, bool* sound_played)
 {
     // So this one is a bit fucking weird because I have to work kinda backwards for everything because of the order of the pushed cards from the hand to the play stack
@@ -1901,12 +2061,13 @@ static void played_cards_update_loop(bool* discarded_card, int* played_selection
             switch (play_state)
             {
                 case PLAY_PLAYING:
-                    if (i == 0 && (timer % FRAMES(10) == 0 || !card_object_is_selected(played[played_top - *played_selections])) && timer > FRAMES(40))
+                    if (i == 0 && (timer % FRAMES(10) == 0 || played_card_skippable(*played_selections)) && timer > FRAMES(40))
                     {
                         (*played_selections)--;
 
                         if (*played_selections == 0)
                         {
+                            played_hand_score();
                             play_state = PLAY_SCORING;
                             timer = TM_ZERO;
                         }
@@ -1920,92 +2081,18 @@ static void played_cards_update_loop(bool* discarded_card, int* played_selection
                 case PLAY_SCORING:
                     if (i == 0 && (timer % FRAMES(30) == 0) && timer > FRAMES(40))
                     {
-                        // So pretend "played_selections" is now called "scored_cards" and it counts the number of cards that have been scored
-                        int scored_cards = 0;
-                        for (int j = 0; j <= played_top; j++)
-                        {
-                            tte_erase_rect_wrapper(PLAYED_CARDS_SCORES_RECT);
+                        tte_erase_rect_wrapper(PLAYED_CARDS_SCORES_RECT);
 
-                            if (*played_selections > 0)
-                            {
-                                for (int k = 0; k < list_get_size(jokers); k++)
-                                {
-                                    JokerObject *joker = list_get(jokers, k);
-                                    if (joker_object_score(joker, played[*played_selections - 1]->card, &chips, &mult, NULL, &money, NULL)) // NULLs aren't implemented yet
-                                    {
-                                        display_chips(chips);
-                                        display_mult(mult);
-                                        display_money(money);
-
-                                        return; 
-                                    }
-                                }
-                            }
-
-                            if (card_object_is_selected(played[j]))
-                            {
-                                scored_cards = j + 1; // Count the number of cards that have been scored
-                                if (scored_cards > *played_selections)
-                                {
-                                    for (int k = 0; k < list_get_size(jokers); k++)
-                                    {
-                                        JokerObject *joker = list_get(jokers, k);
-                                        if (joker != NULL)
-                                        {
-                                            joker->joker->processed = false; // Reset the joker's processed state for the next score
-                                        }
-                                    }
-
-                                    tte_set_pos(fx2int(played[j]->sprite_object->x) + 8, SCORED_CARD_TEXT_Y); // Offset of 16 pixels to center the text on the card
-                                    tte_set_special(0xD000); // Set text color to blue from background memory
-
-                                    // Write the score to a character buffer variable
-                                    char score_buffer[INT_MAX_DIGITS + 2]; // for '+' and null terminator
-                                    snprintf(score_buffer, sizeof(score_buffer), "+%d", card_get_value(played[j]->card));
-                                    tte_write(score_buffer);
-
-                                    *played_selections = scored_cards;
-                                    card_object_shake(played[j], SFX_CARD_SELECT);
-
-                                    // Relocated card scoring logic here
-                                    chips += card_get_value(played[j]->card);
-                                    display_chips(chips);
-
-                                    break;
-                                }
-                            }
-
-                            if (j == played_top && scored_cards == *played_selections) // Check if it's the last card 
-                            {
-                                tte_erase_rect_wrapper(PLAYED_CARDS_SCORES_RECT);
-
-                                for (int k = 0; k <= list_get_size(jokers); k++) // Independent joker scoring loop
-                                {
-                                    JokerObject *joker = list_get(jokers, k);
-                                    if (joker_object_score(joker, NULL, &chips, &mult, NULL, &money, NULL)) // NULLs aren't implemented yet
-                                    {
-                                        display_chips(chips);
-                                        display_mult(mult);
-                                        display_money(money);
-
-                                        return; // Returning was just the easiest way to break out of the loop
-                                    }
-                                }
-
-                                for (int k = 0; k <= list_get_size(jokers); k++)
-                                {
-                                    JokerObject *joker = list_get(jokers, k);
-                                    if (joker != NULL)
-                                    {
-                                        joker->joker->processed = false; // Reset the joker's processed state for the next round
-                                    }
-                                }
-
-                                play_state = PLAY_ENDING;
-                                timer = TM_ZERO;
-                                *played_selections = played_top + 1; // Reset the played selections to the top of the played stack
-                                break;
-                            }
+                        // One scoring event per tick, then move on once they have all been shown
+                        if (scoring_event_idx < score_result.num_events)
+                        {
+                            scoring_event_play(&score_result.events[scoring_event_idx++]);
+                        }
+                        else
+                        {
+                            play_state = PLAY_ENDING;
+                            timer = TM_ZERO;
+                            *played_selections = played_top + 1; // Reset the played selections to the top of the played stack
                         }
                     }
 
@@ -2015,7 +2102,7 @@ static void played_cards_update_loop(bool* discarded_card, int* played_selection
                     }
                     break;
                 case PLAY_ENDING: // This is the reverse of PLAY_PLAYING. The cards get reset back to their neutral position sequentially
-                    if (i == 0 && (timer % FRAMES(10) == 0 || !card_object_is_selected(played[played_top - *played_selections])) && timer > FRAMES(40))
+                    if (i == 0 && (timer % FRAMES(10) == 0 || played_card_skippable(*played_selections)) && timer > FRAMES(40))
                     {
                         (*played_selections)--;
 
@@ -2045,7 +2132,7 @@ static void played_cards_update_loop(bool* discarded_card, int* played_selection
 
                         if (played[i]->sprite_object->x >= played_x)
                         {
-                            discard_push(played[i]->card); // Push the card to the discard pile
+                            discard_push(card_get_code(played[i]->card)); // Push the card to the discard pile
                             card_object_destroy(&played[i]);
 
                             //played_top--; 
@@ -2079,6 +2166,8 @@ static void played_cards_update_loop(bool* discarded_card, int* played_selection
                     break;
             }
 
+            if (played[i] == NULL) continue; // The card was just discarded
+
             played[i]->sprite_object->tx = played_x;
             played[i]->sprite_object->ty = played_y;
             played[i]->sprite_object->tscale = played_scale;
@@ -2148,8 +2237,10 @@ void game_playing()
     static bool sound_played = false;
     bool discarded_card = false;
 
+    PROFILE_BEGIN(PROFILE_ZONE_CARDS);
     cards_in_hand_update_loop(&discarded_card, &played_selections, &sound_played);
 	played_cards_update_loop(&discarded_card, &played_selections, &sound_played);
+    PROFILE_END(PROFILE_ZONE_CARDS);
     
     game_playing_ui_text_update();
 }
@@ -2196,7 +2287,10 @@ void game_round_end()
         }
         case DISPLAY_FINISHED_BLIND: // Display the beaten blind, expand the panel border down a tile and wait until a bit until going to the next state
         {
-            obj_unhide(round_end_blind_token->obj, 0);
+            if (round_end_blind_token != NULL)
+            {
+                sprite_unhide(round_end_blind_token, 0);
+            }
             
             int current_ante = ante;
             if (current_blind == BLIND_TYPE_BOSS) current_ante--; // Beating the boss blind increases the ante, so we need to display the previous ante value
@@ -2258,7 +2352,10 @@ void game_round_end()
             {
                 tte_erase_rect_wrapper(BLIND_REWARD_RECT);
                 tte_erase_rect_wrapper(BLIND_REQ_TEXT_RECT);
-                obj_hide(playing_blind_token->obj);
+                if (playing_blind_token != NULL)
+                {
+                    sprite_hide(playing_blind_token);
+                }
                 affine_background_load_palette(affine_background_gfxPal);
                 state = BLIND_PANEL_EXIT;
                 timer = TM_ZERO;
@@ -2293,7 +2390,7 @@ void game_round_end()
             }   
             else if (timer > FRAMES(20))
             {
-                memset16(&pal_bg_mem[REWARD_PANEL_BORDER_PID], 0x1483, 1);
+                vram_queue_fill16(&pal_bg_mem[REWARD_PANEL_BORDER_PID], 0x1483, 1);
                 state = DISPLAY_REWARDS;
                 timer = TM_ZERO;
             }
@@ -2391,7 +2488,10 @@ void game_round_end()
                 state = DISMISS_ROUND_END_PANEL; // Go to the next state
                 timer = TM_ZERO; // Reset the timer
             
-                obj_hide(round_end_blind_token->obj); // Hide the blind token object
+                if (round_end_blind_token != NULL)
+                {
+                    sprite_hide(round_end_blind_token); // Hide the blind token object
+                }
                 tte_erase_rect_wrapper(BLIND_TOKEN_TEXT_RECT); // Erase the blind token text
             }
 
@@ -2418,12 +2518,18 @@ void game_round_end()
             interest_reward = 0;
             game_round_end_cleanup();
             game_set_state(GAME_SHOP);
+            game_save(GAME_SHOP); // The shop items are rolled in the intro, so a continued run gets the same ones
             break;
     }
 }
 
 // Shop
-static List *shop_jokers = NULL;
+static JokerObjectList shop_jokers;
+
+JokerObjectList *get_shop_jokers(void)
+{
+    return &shop_jokers;
+}
 #define REROLL_BASE_COST 5 // Base cost for rerolling the shop items
 static int reroll_cost = REROLL_BASE_COST;
 
@@ -2454,35 +2560,42 @@ void erase_price_under_sprite_object(SpriteObject *sprite_object)
 static void game_shop_create_items()
 {
     tte_erase_rect_wrapper(SHOP_PRICES_TEXT_RECT);
-    if (list_get_size(jokers_available_to_shop) == 0)
+    if (jokers_available_to_shop.size == 0)
     {
         // No jokers to create
         return;
     }
 
-    shop_jokers = list_new(MAX_SHOP_JOKERS);
-
     for (int i = 0; i < MAX_SHOP_JOKERS; i++)
     {
         int joker_idx = 0;
-        intptr_t joker_id = 0;
+        int joker_id = 0;
         #ifdef TEST_JOKER_ID // Allow defining an ID for a joker to always appear in shop and be tested
-        if (int_list_exists(jokers_available_to_shop, TEST_JOKER_ID))
+        joker_idx = joker_id_list_find(&jokers_available_to_shop, TEST_JOKER_ID);
+        if (joker_idx != UNDEFINED)
         {
             joker_id = TEST_JOKER_ID;
-            int_list_remove_by_value(jokers_available_to_shop, joker_id);
+            joker_id_list_remove(&jokers_available_to_shop, joker_idx);
         }
         else
         #endif
         {
-           joker_idx = random() % list_get_size(jokers_available_to_shop);
-           joker_id = int_list_get(jokers_available_to_shop, joker_idx);
+           joker_idx = rng_range(RNG_SHOP, jokers_available_to_shop.size);
+           joker_id = joker_id_list_get(&jokers_available_to_shop, joker_idx);
            // TODO: weight the random choice by joker rarity
-            list_remove_by_idx(jokers_available_to_shop, joker_idx);
+           // Keeps the order so the same seed still offers the same jokers
+            joker_id_list_remove(&jokers_available_to_shop, joker_idx);
         }
         
         
-        JokerObject *joker_object = joker_object_new(joker_new(joker_id));
+        Joker *joker = joker_new(joker_id);
+        JokerObject *joker_object = joker_object_new(joker);
+        if (joker_object == NULL) // Out of palette banks, the slot stays empty and the joker can be offered later
+        {
+            joker_destroy(&joker);
+            joker_id_list_append(&jokers_available_to_shop, joker_id);
+            continue;
+        }
 
         joker_object->sprite_object->x = int2fx(120 + i * CARD_SPRITE_SIZE);
         joker_object->sprite_object->y = int2fx(160);
@@ -2492,7 +2605,7 @@ static void game_shop_create_items()
         print_price_under_sprite_object(joker_object->sprite_object, joker_object->joker->value);
 
         sprite_position(joker_object_get_sprite(joker_object), fx2int(joker_object->sprite_object->x), fx2int(joker_object->sprite_object->y));
-        list_append(shop_jokers, joker_object);
+        joker_object_list_append(&shop_jokers, joker_object);
     }
 }
 
@@ -2534,28 +2647,22 @@ static void game_shop_reroll(int *reroll_cost)
 {
     money -= *reroll_cost;
     display_money(money); // Update the money display
-    for (int i = 0; i < list_get_size(shop_jokers); i++)
+    for (int i = 0; i < shop_jokers.size; i++)
     {
-        JokerObject *joker_object = list_get(shop_jokers, i);
-        if (joker_object != NULL)
-        {
-            int_list_append(jokers_available_to_shop, joker_object->joker->id);
-            joker_object_destroy(&joker_object); // Destroy the joker object if it exists
-        }
+        JokerObject *joker_object = shop_jokers.items[i];
+        joker_id_list_append(&jokers_available_to_shop, joker_object->joker->id);
+        joker_object_destroy(&joker_object);
     }
 
-    list_destroy(&shop_jokers);
+    joker_object_list_clear(&shop_jokers);
 
     game_shop_create_items();
     
-    for (int i = 0; i < list_get_size(shop_jokers); i++)
+    for (int i = 0; i < shop_jokers.size; i++)
     {
-        JokerObject *joker_object = list_get(shop_jokers, i);
-        if (joker_object != NULL)
-        {
-            joker_object->sprite_object->y = joker_object->sprite_object->ty; // Set the y position to the target position
-            joker_object_shake(joker_object, UNDEFINED); // Give the joker a little wiggle animation
-        }
+        JokerObject *joker_object = shop_jokers.items[i];
+        joker_object->sprite_object->y = joker_object->sprite_object->ty; // Set the y position to the target position
+        joker_object_shake(joker_object, UNDEFINED); // Give the joker a little wiggle animation
     }
 
     (*reroll_cost)++;
@@ -2564,7 +2671,7 @@ static void game_shop_reroll(int *reroll_cost)
 
 static int jokers_sel_row_get_size()
 {
-    return list_get_size(jokers);
+    return jokers.size;
 }
 
 static void jokers_sel_row_on_selection_changed(SelectionGrid *selection_grid,
@@ -2574,14 +2681,14 @@ static void jokers_sel_row_on_selection_changed(SelectionGrid *selection_grid,
 {
     if (prev_selection->y == row_idx)
     {
-        JokerObject* joker_object = list_get(jokers, prev_selection->x);
+        JokerObject* joker_object = jokers.items[prev_selection->x];
         erase_price_under_sprite_object(joker_object->sprite_object);
         sprite_object_set_focus(joker_object->sprite_object, false);
     }
 
     if (new_selection->y == row_idx)
     {
-        JokerObject* joker_object = list_get(jokers, new_selection->x);
+        JokerObject* joker_object = jokers.items[new_selection->x];
         sprite_object_set_focus(joker_object->sprite_object, true);
         print_price_under_sprite_object(joker_object->sprite_object, joker_get_sell_value(joker_object->joker));
     }
@@ -2591,21 +2698,25 @@ void joker_start_discard_animation(JokerObject *joker_object)
 {
     joker_object->sprite_object->tx = int2fx(JOKER_DISCARD_TARGET.x);
     joker_object->sprite_object->ty = int2fx(JOKER_DISCARD_TARGET.y);
-    list_append(discarded_jokers, joker_object);
+    if (!joker_object_list_append(&discarded_jokers, joker_object))
+    {
+        // Too many sold at once to animate them all
+        joker_object_destroy(&joker_object);
+    }
 }
 
 void game_sell_joker(int joker_idx)
 {
-    if (joker_idx < 0 || joker_idx > list_get_size(jokers))
+    if (joker_idx < 0 || joker_idx >= jokers.size)
         return;
     
-    JokerObject *joker_object = list_get(jokers, joker_idx);
+    JokerObject *joker_object = jokers.items[joker_idx];
     money += joker_get_sell_value(joker_object->joker);
     display_money(money);
     erase_price_under_sprite_object(joker_object->sprite_object);
 
     remove_held_joker(joker_idx);
-    int_list_append(jokers_available_to_shop, (intptr_t)joker_object->joker->id);
+    joker_id_list_append(&jokers_available_to_shop, joker_object->joker->id);
 
     joker_start_discard_animation(joker_object);
 }
@@ -2623,7 +2734,7 @@ static void jokers_sel_row_on_key_hit(SelectionGrid* selection_grid, Selection*
 // Shop input
 static int shop_top_row_get_size()
 {
-    return list_get_size(shop_jokers) + 1; // + 1 to account for next round button
+    return shop_jokers.size + 1; // + 1 to account for next round button
 }
 
 static void add_to_held_jokers(JokerObject *joker_object)
@@ -2634,14 +2745,14 @@ static void add_to_held_jokers(JokerObject *joker_object)
 
 static void game_shop_buy_joker(int shop_joker_idx)
 {
-    JokerObject *joker_object = list_get(shop_jokers, shop_joker_idx);
+    JokerObject *joker_object = shop_jokers.items[shop_joker_idx];
 
     money -= joker_object->joker->value; // Deduct the money spent on the joker
     display_money(money);                // Update the money display
     erase_price_under_sprite_object(joker_object->sprite_object);
     sprite_object_set_focus(joker_object->sprite_object, false);
     add_to_held_jokers(joker_object);
-    list_remove_by_idx(shop_jokers, shop_joker_idx); // Remove the joker from the shop
+    joker_object_list_remove(&shop_jokers, shop_joker_idx); // Remove the joker from the shop, the ones after it move left
 }
 
 static void shop_top_row_on_key_hit(SelectionGrid* selection_grid, Selection* selection)
@@ -2656,7 +2767,7 @@ static void shop_top_row_on_key_hit(SelectionGrid* selection_grid, Selection* se
         timer = TM_ZERO; // Reset the timer
         reroll_cost = REROLL_BASE_COST;
 
-        memcpy16(&pal_bg_mem[NEXT_ROUND_BTN_SELECTED_BORDER_PID], &pal_bg_mem[SHOP_PANEL_SHADOW_PID], 1);
+        vram_queue_copy16(&pal_bg_mem[NEXT_ROUND_BTN_SELECTED_BORDER_PID], &pal_bg_mem[SHOP_PANEL_SHADOW_PID], 1);
 
         // memcpy16(&pal_bg_mem[16], &pal_bg_mem[6], 1); 
         // This changes the color of the button to a dark red.
@@ -2666,10 +2777,9 @@ static void shop_top_row_on_key_hit(SelectionGrid* selection_grid, Selection* se
     else 
     {
         int shop_joker_idx = selection->x - 1; // - 1 to account for next round button
-        JokerObject *joker_object = list_get(shop_jokers, shop_joker_idx);
-        if (joker_object == NULL 
-            || list_get_size(jokers) >= MAX_JOKERS_HELD_SIZE
-            || money < joker_object->joker->value)
+        if (shop_joker_idx >= shop_jokers.size
+            || jokers.size >= MAX_JOKERS_HELD_SIZE
+            || money < shop_jokers.items[shop_joker_idx]->joker->value)
         {
             return;
         }
@@ -2691,11 +2801,11 @@ static void shop_top_row_on_selection_changed(SelectionGrid* selection_grid, int
         if (prev_selection->x == NEXT_ROUND_BTN_SEL_X)
         {
             // Remove next round button highlight
-            memcpy16(&pal_bg_mem[NEXT_ROUND_BTN_SELECTED_BORDER_PID], &pal_bg_mem[NEXT_ROUND_BTN_PID], 1);
+            vram_queue_copy16(&pal_bg_mem[NEXT_ROUND_BTN_SELECTED_BORDER_PID], &pal_bg_mem[NEXT_ROUND_BTN_PID], 1);
         }
         else 
         {
-            JokerObject *joker = list_get(shop_jokers, prev_selection->x - 1);
+            JokerObject *joker = shop_jokers.items[prev_selection->x - 1];
             sprite_object_set_focus(joker->sprite_object, false); 
             // -1 to account for next round button
         }
@@ -2706,11 +2816,11 @@ static void shop_top_row_on_selection_changed(SelectionGrid* selection_grid, int
         if (new_selection->x == NEXT_ROUND_BTN_SEL_X)
         {
             // Highlight next round button
-            memset16(&pal_bg_mem[NEXT_ROUND_BTN_SELECTED_BORDER_PID], HIGHLIGHT_COLOR, 1);
+            vram_queue_fill16(&pal_bg_mem[NEXT_ROUND_BTN_SELECTED_BORDER_PID], HIGHLIGHT_COLOR, 1);
         }
         else 
         {
-            JokerObject *joker = list_get(shop_jokers, new_selection->x - 1);
+            JokerObject *joker = shop_jokers.items[new_selection->x - 1];
             sprite_object_set_focus(joker->sprite_object, true); 
             // -1 to account for next round button
         }
@@ -2727,11 +2837,11 @@ static void shop_reroll_row_on_selection_changed(SelectionGrid* selection_grid,
     if (row_idx == prev_selection->y)
     {
         // Remove highlight
-        memcpy16(&pal_bg_mem[REROLL_BTN_SELECTED_BORDER_PID], &pal_bg_mem[REROLL_BTN_PID], 1);
+        vram_queue_copy16(&pal_bg_mem[REROLL_BTN_SELECTED_BORDER_PID], &pal_bg_mem[REROLL_BTN_PID], 1);
     }
     else if (row_idx == new_selection->y)
     {
-        memset16(&pal_bg_mem[REROLL_BTN_SELECTED_BORDER_PID], HIGHLIGHT_COLOR, 1);
+        vram_queue_fill16(&pal_bg_mem[REROLL_BTN_SELECTED_BORDER_PID], HIGHLIGHT_COLOR, 1);
     }
 }
 
@@ -2772,27 +2882,19 @@ static void game_shop_process_user_input()
 
 static void game_shop_lights_anim_frame()
 {
-    // Shift palette around the border of the shop icon
-    COLOR shifted_palette[4];
-    memcpy16(&shifted_palette[0], &pal_bg_mem[SHOP_LIGHTS_2_PID], 1);
-    memcpy16(&shifted_palette[1], &pal_bg_mem[SHOP_LIGHTS_3_PID], 1);
-    memcpy16(&shifted_palette[2], &pal_bg_mem[SHOP_LIGHTS_4_PID], 1);
-    memcpy16(&shifted_palette[3], &pal_bg_mem[SHOP_LIGHTS_1_PID], 1);
+    // Shift the colors around the border of the shop icon by one light.
+    // They are worked out from how far they have turned instead of read back from the palette,
+    // which may still have the reset colors queued for VBlank
+    static const u16 shop_lights_pids[NUM_SHOP_LIGHTS] = {SHOP_LIGHTS_1_PID, SHOP_LIGHTS_2_PID, SHOP_LIGHTS_3_PID, SHOP_LIGHTS_4_PID};
+    static const COLOR shop_lights_colors[NUM_SHOP_LIGHTS] = {SHOP_LIGHTS_1_CLR, SHOP_LIGHTS_2_CLR, SHOP_LIGHTS_3_CLR, SHOP_LIGHTS_4_CLR};
 
-    // Circularly shift the palette
-    int last = shifted_palette[3];
+    shop_lights_phase = (shop_lights_phase + 1) % NUM_SHOP_LIGHTS;
 
-    for (int i = 3; i > 0; --i)
+    for (int i = 0; i < NUM_SHOP_LIGHTS; i++)
     {
-        shifted_palette[i] = shifted_palette[i - 1];
+        int color_idx = (i - shop_lights_phase + NUM_SHOP_LIGHTS) % NUM_SHOP_LIGHTS;
+        vram_queue_fill16(&pal_bg_mem[shop_lights_pids[i]], shop_lights_colors[color_idx], 1);
     }
-
-    shifted_palette[0] = last;
-
-    memcpy16(&pal_bg_mem[SHOP_LIGHTS_2_PID], &shifted_palette[0], 1); // Copy the shifted palette to the next 4 slots
-    memcpy16(&pal_bg_mem[SHOP_LIGHTS_3_PID], &shifted_palette[1], 1);
-    memcpy16(&pal_bg_mem[SHOP_LIGHTS_4_PID], &shifted_palette[2], 1);
-    memcpy16(&pal_bg_mem[SHOP_LIGHTS_1_PID], &shifted_palette[3], 1);
 }
 
 // Outro sequence (menu and shop icon going out of frame)
@@ -2809,13 +2911,9 @@ static void game_shop_outro()
     {
         tte_erase_rect_wrapper(SHOP_PRICES_TEXT_RECT); // Erase the shop prices text
 
-        for (int i = 0; i < list_get_size(shop_jokers); i++)
+        for (int i = 0; i < shop_jokers.size; i++)
         {
-            JokerObject *joker_object = list_get(shop_jokers, i);
-            if (joker_object != NULL)
-            {
-                joker_object->sprite_object->ty = int2fx(160);
-            }
+            shop_jokers.items[i]->sprite_object->ty = int2fx(160);
         }
 
         int y = 6;
@@ -2845,16 +2943,9 @@ void game_shop()
 {
     change_background(BG_ID_SHOP);
 
-    if (shop_jokers != NULL)
+    for (int i = 0; i < shop_jokers.size; i++)
     {
-        for (int i = 0; i < list_get_size(shop_jokers); i++)
-        {
-            JokerObject *joker_object = list_get(shop_jokers, i);
-            if (joker_object != NULL)
-            {
-                joker_object_update(joker_object);
-            }
-        }
+        joker_object_update(shop_jokers.items[i]);
     }
 
     if (timer % 20 == 0)
@@ -2882,21 +2973,19 @@ void game_shop()
         default:
             state = 0; // Reset the state
 
-            for (int i = 0; i < list_get_size(shop_jokers); i++)
+            for (int i = 0; i < shop_jokers.size; i++)
             {
-                JokerObject* joker_object = list_get(shop_jokers, i);
-                if (joker_object != NULL)
-                {
-                    // Make the joker available back to shop                    
-                    int_list_append(jokers_available_to_shop, (intptr_t)joker_object->joker->id);
-                }
+                JokerObject* joker_object = shop_jokers.items[i];
+                // Make the joker available back to shop
+                joker_id_list_append(&jokers_available_to_shop, joker_object->joker->id);
                 joker_object_destroy(&joker_object); // Destroy the joker objects
             }
 
-            list_destroy(&shop_jokers);
+            joker_object_list_clear(&shop_jokers);
 
             increment_blind(BLIND_STATE_DEFEATED); // TODO: Move to game_round_end()?
             game_set_state(GAME_BLIND_SELECT); // If we reach here, we should go to the blind select state
+            game_save(GAME_BLIND_SELECT);
 
             break;
     }
@@ -2913,7 +3002,7 @@ void game_blind_select()
 
             for (int i = 0; i < BLIND_TYPE_MAX; i++)
             {
-                sprite_position(blind_select_tokens[i], blind_select_tokens[i]->pos.x, blind_select_tokens[i]->pos.y - TILE_SIZE);
+                blind_select_token_move_y(i, -TILE_SIZE);
             }
 
             if (timer == TM_END_ANIM_SEQ)
@@ -2951,6 +3040,7 @@ void game_blind_select()
                 else if (current_blind != BLIND_TYPE_BOSS)
                 {
                     increment_blind(BLIND_STATE_SKIPPED);
+                    game_save(GAME_BLIND_SELECT);
                     
                     background = UNDEFINED; // Force refresh of the background
                     change_background(BG_ID_BLIND_SELECT);
@@ -2963,7 +3053,7 @@ void game_blind_select()
 
                     for (int i = 0; i < BLIND_TYPE_MAX; i++)
                     {
-                        sprite_position(blind_select_tokens[i], blind_select_tokens[i]->pos.x, blind_select_tokens[i]->pos.y - (TILE_SIZE * 12));
+                        blind_select_token_move_y(i, -(TILE_SIZE * 12));
                     }
 
                     timer = TM_ZERO;
@@ -2973,13 +3063,13 @@ void game_blind_select()
             if (selection_y == 0)
             {
 				// 5 is the multiplier palette color and the skip button color
-                memset16(&pal_bg_mem[BLIND_SELECT_BTN_SELECTED_BORDER_PID], HIGHLIGHT_COLOR, 1);
-                memcpy16(&pal_bg_mem[BLIND_SKIP_BTN_SELECTED_BORDER_PID], &pal_bg_mem[BLIND_SKIP_BTN_PID], 1);
+                vram_queue_fill16(&pal_bg_mem[BLIND_SELECT_BTN_SELECTED_BORDER_PID], HIGHLIGHT_COLOR, 1);
+                vram_queue_copy16(&pal_bg_mem[BLIND_SKIP_BTN_SELECTED_BORDER_PID], &pal_bg_mem[BLIND_SKIP_BTN_PID], 1);
             }
             else
             {
-                memcpy16(&pal_bg_mem[BLIND_SELECT_BTN_SELECTED_BORDER_PID], &pal_bg_mem[BLIND_SELECT_BTN_PID], 1);
-                memset16(&pal_bg_mem[BLIND_SKIP_BTN_SELECTED_BORDER_PID], HIGHLIGHT_COLOR, 1);
+                vram_queue_copy16(&pal_bg_mem[BLIND_SELECT_BTN_SELECTED_BORDER_PID], &pal_bg_mem[BLIND_SELECT_BTN_PID], 1);
+                vram_queue_fill16(&pal_bg_mem[BLIND_SKIP_BTN_SELECTED_BORDER_PID], HIGHLIGHT_COLOR, 1);
             }
 
             break;
@@ -2994,14 +3084,14 @@ void game_blind_select()
 
                 for (int i = 0; i < BLIND_TYPE_MAX; i++)
                 {
-                    sprite_position(blind_select_tokens[i], blind_select_tokens[i]->pos.x, blind_select_tokens[i]->pos.y + TILE_SIZE);
+                    blind_select_token_move_y(i, TILE_SIZE);
                 }
             }
             else if (timer >= MENU_POP_OUT_ANIM_FRAMES)
             {
                 for (int i = 0; i < BLIND_TYPE_MAX; i++)
                 {
-                    obj_hide(blind_select_tokens[i]->obj);
+                    blind_select_token_set_visible(i, false);
                 }
 
                 state++; // Reset the state
@@ -3099,35 +3189,39 @@ void game_main_menu()
     if (selection_x == 0) // Play button
     {   
         // Select button PID is 5 and the outline is 3
-        memset16(&pal_bg_mem[MAIN_MENU_PLAY_BUTTON_OUTLINE_PID], HIGHLIGHT_COLOR, 1);
+        vram_queue_fill16(&pal_bg_mem[MAIN_MENU_PLAY_BUTTON_OUTLINE_PID], HIGHLIGHT_COLOR, 1);
 
         if (key_hit(KEY_A))
         {
-            // Start the game
-            game_start();
+            // Continue the saved run, holding SELECT starts a new one over it
+            if (save_exists() && !key_is_down(KEY_SELECT))
+            {
+                game_continue();
+            }
+            else
+            {
+                game_start();
+            }
         }
     }
     else
     {
         // Select button PID is 5 and the outline is 3
-        memcpy16(&pal_bg_mem[MAIN_MENU_PLAY_BUTTON_OUTLINE_PID], &pal_bg_mem[MAIN_MENU_PLAY_BUTTON_MAIN_COLOR_PID], 1);
+        vram_queue_copy16(&pal_bg_mem[MAIN_MENU_PLAY_BUTTON_OUTLINE_PID], &pal_bg_mem[MAIN_MENU_PLAY_BUTTON_MAIN_COLOR_PID], 1);
     }
 }
 
 static void discarded_jokers_update_loop()
 {
-    if (discarded_jokers == NULL)
-        return;
-    
-    // Iterating backwards because of removal within loop
-    for (int i = list_get_size(discarded_jokers) - 1; i >= 0; i--)
+    // Iterating backwards because of removal within loop, the swapped in element was already updated
+    for (int i = discarded_jokers.size - 1; i >= 0; i--)
     {
-        JokerObject* joker_object = list_get(discarded_jokers, i);
+        JokerObject* joker_object = discarded_jokers.items[i];
         joker_object_update(joker_object);
         if (joker_object->sprite_object->x == joker_object->sprite_object->tx
             && joker_object->sprite_object->y == joker_object->sprite_object->ty)
         {
-            list_remove_by_idx(discarded_jokers, i);
+            joker_object_list_swap_remove(&discarded_jokers, i);
             joker_object_destroy(&joker_object);        
         }
     }
@@ -3146,10 +3240,10 @@ static void held_jokers_update_loop()
 
     FIXED hand_x = int2fx(HELD_JOKERS_POS.x);
 
-    int jokers_top = list_get_size(jokers) - 1;
+    int jokers_top = jokers.size - 1;
     for (int i = jokers_top; i >= 0; i--)
     {
-        JokerObject *joker = list_get(jokers, i);
+        JokerObject *joker = jokers.items[i];
         joker->sprite_object->tx = hand_x - int2fx(spacing_lut[jokers_top][i]);
 
         joker_object_update(joker);
@@ -3195,7 +3289,13 @@ void game_update()
 {
     timer++;
 
+    PROFILE_BEGIN(PROFILE_ZONE_JOKERS);
     jokers_update_loop();
+    PROFILE_END(PROFILE_ZONE_JOKERS);
+
+    // The state can change during the update, its time goes to the state it started in
+    enum ProfileZone state_zone = PROFILE_ZONE_GAME_STATE(game_state);
+    PROFILE_BEGIN(state_zone);
 
     switch (game_state)
     {
@@ -3224,4 +3324,41 @@ void game_update()
             game_win();
             break;
     }
+
+    PROFILE_END(state_zone);
+}
+
+// Scanline after which no more idle work is started, the margin covers one solver step
+#define IDLE_VCOUNT_LIMIT 140
+
+// True until the display gets close to the next VBlank.
+// The frame starts at VBlank so the VBlank scanlines are still this frame's time.
+static bool frame_time_left(void)
+{
+    int vcount = REG_VCOUNT;
+    return vcount >= SCREEN_HEIGHT || vcount < IDLE_VCOUNT_LIMIT;
+}
+
+void game_idle()
+{
+    if (game_state != GAME_PLAYING || hand_state != HAND_SELECT)
+    {
+        hint_reset();
+        return;
+    }
+
+    if (hint_is_stale())
+    {
+        hint_start();
+    }
+
+    while (!solver_is_done(&hint_solver) && frame_time_left())
+    {
+        solver_step(&hint_solver);
+    }
+
+    if (solver_is_done(&hint_solver) && !hint_shown)
+    {
+        hint_show();
+    }
 }
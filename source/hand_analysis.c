@@ -2,87 +2,273 @@
 #include "card.h"
 #include "game.h"
 
-static void get_distribution(CardObject **cards, int top, u8 *ranks_out, u8 *suits_out) {
-    for (int i = 0; i < NUM_RANKS; i++) ranks_out[i] = 0;
-    for (int i = 0; i < NUM_SUITS; i++) suits_out[i] = 0;
+// Every lane of the packed rank/suit counts set to 1
+#define RANK_LANES_ONES 0x11111111
+#define RANK_LANES_HIGH_BITS 0x88888888
+#define SUIT_LANES_ONES 0x01010101
+#define SUIT_LANES_HIGH_BITS 0x80808080
+
+#define STRAIGHT_SIZE 5
+#define ROYAL_RANKS_MASK ((1 << TEN) | (1 << JACK) | (1 << QUEEN) | (1 << KING) | (1 << ACE))
+
+static void get_distribution(CardObject **cards, int top, HandDistribution *dist_out) {
+    hand_distribution_clear(dist_out);
 
     for (int i = 0; i <= top; i++) {
         if (cards[i] && card_object_is_selected(cards[i])) {
-            ranks_out[cards[i]->card->rank]++;
-            suits_out[cards[i]->card->suit]++;
+            hand_distribution_add_card(dist_out, cards[i]->card);
         }
     }
 }
 
-void get_hand_distribution(u8 *ranks_out, u8 *suits_out) {
-    get_distribution(get_hand_array(), get_hand_top(), ranks_out, suits_out);
+void get_hand_distribution(HandDistribution *dist_out) {
+    get_distribution(get_hand_array(), get_hand_top(), dist_out);
 }
 
-void get_played_distribution(u8 *ranks_out, u8 *suits_out) {
-    get_distribution(get_played_array(), get_played_top(), ranks_out, suits_out);
+void get_played_hand_context(HandContext *context_out, enum HandType hand_type) {
+    CardObject **played = get_played_array();
+    int played_top = get_played_top();
+
+    // The played cards that score are the selected ones at this point
+    Card *scoring_cards[MAX_SELECTION_SIZE];
+    int num_scoring_cards = 0;
+    for (int i = 0; i <= played_top && num_scoring_cards < MAX_SELECTION_SIZE; i++) {
+        if (played[i] && card_object_is_selected(played[i]))
+            scoring_cards[num_scoring_cards++] = played[i]->card;
+    }
+
+    CardObject **hand = get_hand_array();
+    int hand_top = get_hand_top();
+
+    Card *held_cards[MAX_HAND_SIZE];
+    int num_held_cards = 0;
+    for (int i = 0; i <= hand_top; i++) {
+        if (hand[i])
+            held_cards[num_held_cards++] = hand[i]->card;
+    }
+
+    hand_context_make(context_out, hand_type, played_top + 1, scoring_cards, num_scoring_cards, held_cards, num_held_cards);
 }
 
-// Returns the highest N of a kind. So a full-house would return 3.
-u8 hand_contains_n_of_a_kind(u8 *ranks) {
-    u8 highest_n = 0;
-    for (int i = 0; i < NUM_RANKS; i++) {
-        if (ranks[i] > highest_n)
-            highest_n = ranks[i];
+void hand_context_make(HandContext *context_out, enum HandType hand_type, int num_played_cards, Card *scoring_cards[], int num_scoring_cards,
+                       Card *held_cards[], int num_held_cards) {
+    hand_distribution_clear(&context_out->distribution);
+    context_out->hand_type = hand_type;
+    context_out->played_count = num_played_cards;
+    context_out->scoring_count = num_scoring_cards;
+    context_out->face_count = 0;
+
+    for (int i = 0; i < num_scoring_cards; i++) {
+        hand_distribution_add_card(&context_out->distribution, scoring_cards[i]);
+        if (card_is_face(scoring_cards[i]))
+            context_out->face_count++;
     }
-    return highest_n;
+
+    context_out->held_count = num_held_cards;
+    for (int i = 0; i < num_held_cards; i++) {
+        context_out->held_cards[i] = held_cards[i];
+    }
+
+    context_out->money = get_money();
+    context_out->money_earned = 0;
 }
 
-bool hand_contains_two_pair(u8 *ranks) {
-    bool contains_other_pair = false;
-    for (int i = 0; i < NUM_RANKS; i++) {
-        if (ranks[i] >= 2) {
-            if (contains_other_pair)
-                return true;
-            contains_other_pair = true;
+// Flags the first group of n cards of the same rank that aren't flagged yet, starting from the first card.
+// Returns false if there is none.
+static bool flag_same_rank_cards(Card *cards[], int num_cards, int n, bool is_scoring[]) {
+    for (int i = 0; i < num_cards - 1; i++) {
+        if (is_scoring[i])
+            continue;
+
+        int found = 1;
+        for (int j = i + 1; j < num_cards && found < n; j++) {
+            if (!is_scoring[j] && cards[j]->rank == cards[i]->rank)
+                found++;
+        }
+
+        if (found < n)
+            continue;
+
+        is_scoring[i] = true;
+        found = 1;
+        for (int j = i + 1; j < num_cards && found < n; j++) {
+            if (!is_scoring[j] && cards[j]->rank == cards[i]->rank) {
+                is_scoring[j] = true;
+                found++;
+            }
         }
+        return true;
     }
+
     return false;
 }
 
-bool hand_contains_full_house(u8* ranks) {
-    int count_three = 0;
-    int count_pair = 0;
-    for (int i = 0; i < NUM_RANKS; i++) {
-        if (ranks[i] >= 3) {
-            count_three++;
-        }
-        else if (ranks[i] >= 2) {
-            count_pair++;
+void hand_get_scoring_cards(Card *cards[], int num_cards, enum HandType hand_type, bool is_scoring_out[]) {
+    for (int i = 0; i < num_cards; i++) {
+        is_scoring_out[i] = false;
+    }
+
+    switch (hand_type) {
+        case NONE:
+            break;
+        case HIGH_CARD: { // The card with the highest rank, the first one on ties
+            int highest_rank_index = 0;
+            for (int i = 1; i < num_cards; i++) {
+                if (cards[i]->rank > cards[highest_rank_index]->rank)
+                    highest_rank_index = i;
+            }
+            is_scoring_out[highest_rank_index] = true;
+            break;
         }
+        case PAIR:
+            flag_same_rank_cards(cards, num_cards, 2, is_scoring_out);
+            break;
+        case TWO_PAIR:
+            flag_same_rank_cards(cards, num_cards, 2, is_scoring_out);
+            flag_same_rank_cards(cards, num_cards, 2, is_scoring_out);
+            break;
+        case THREE_OF_A_KIND:
+            flag_same_rank_cards(cards, num_cards, 3, is_scoring_out);
+            break;
+        case FOUR_OF_A_KIND:
+            flag_same_rank_cards(cards, num_cards, 4, is_scoring_out);
+            break;
+        case STRAIGHT:
+        case FLUSH:
+        case FULL_HOUSE:
+        case STRAIGHT_FLUSH:
+        case ROYAL_FLUSH:
+        case FIVE_OF_A_KIND:
+        case FLUSH_HOUSE:
+        case FLUSH_FIVE: // All the played cards score
+            for (int i = 0; i < num_cards; i++) {
+                is_scoring_out[i] = true;
+            }
+            break;
+    }
+}
+
+// Returns a mask with the high bit of every 4-bit lane set where the lane holds at least n.
+// Adding 8 - n to a lane carries into its high bit exactly when the lane is >= n.
+static inline u32 rank_lanes_at_least(u32 counts, u32 n) {
+    return (counts + RANK_LANES_ONES * (8 - n)) & RANK_LANES_HIGH_BITS;
+}
+
+static inline bool any_rank_at_least(const HandDistribution *dist, u32 n) {
+    return (rank_lanes_at_least(dist->rank_counts[0], n) | rank_lanes_at_least(dist->rank_counts[1], n)) != 0;
+}
+
+// True if at least two different ranks have n or more cards
+static inline bool two_ranks_at_least(const HandDistribution *dist, u32 n) {
+    u32 low = rank_lanes_at_least(dist->rank_counts[0], n);
+    u32 high = rank_lanes_at_least(dist->rank_counts[1], n);
+
+    // x & (x - 1) clears the lowest set bit so it's non-zero if more than one lane is set
+    return (low & (low - 1)) || (high & (high - 1)) || (low && high);
+}
+
+// Returns the highest N of a kind. So a full-house would return 3.
+ARM_IWRAM_CODE u8 hand_contains_n_of_a_kind(const HandDistribution *dist) {
+    u8 highest_n = 0;
+    // Lanes are 4 bits wide so the lane test holds up to 8
+    while (highest_n < 8 && any_rank_at_least(dist, highest_n + 1)) {
+        highest_n++;
     }
+    return highest_n;
+}
+
+ARM_IWRAM_CODE bool hand_contains_two_pair(const HandDistribution *dist) {
+    return two_ranks_at_least(dist, 2);
+}
+
+ARM_IWRAM_CODE bool hand_contains_full_house(const HandDistribution *dist) {
     // Full house if there is:
     // - at least one three-of-a-kind and at least one other pair,
     // - OR at least two three-of-a-kinds (second "three" acts as pair).
+    // Both cases mean a rank with three or more and two ranks with two or more.
     // This accounts for hands with 6 or more cards even though
     // they are currently not possible and probably never will be.
-    return (count_three >= 2 || (count_three && count_pair));
+    return any_rank_at_least(dist, 3) && two_ranks_at_least(dist, 2);
 }
 
-bool hand_contains_straight(u8 *ranks) {
-    for (int i = 0; i < NUM_RANKS - 4; i++)
-    {
-        if (ranks[i] && ranks[i + 1] && ranks[i + 2] && ranks[i + 3] && ranks[i + 4])
-            return true;
+ARM_IWRAM_CODE bool hand_contains_straight(const HandDistribution *dist) {
+    // Shift every rank up by one and put the ace at the bottom as well for the ace low straight
+    u32 ranks = (dist->rank_mask << 1) | ((dist->rank_mask >> ACE) & 1);
+
+    // A bit survives only if it and the next STRAIGHT_SIZE - 1 ranks are all present
+    for (int i = 1; i < STRAIGHT_SIZE; i++) {
+        ranks &= ranks >> 1;
     }
-    // Check for ace low straight
-    if (ranks[ACE] && ranks[TWO] && ranks[THREE] && ranks[FOUR] && ranks[FIVE])
-        return true;
+    return ranks != 0;
+}
 
-    return false;
+ARM_IWRAM_CODE bool hand_contains_royal(const HandDistribution *dist) {
+    return (dist->rank_mask & ROYAL_RANKS_MASK) == ROYAL_RANKS_MASK;
+}
+
+ARM_IWRAM_CODE bool hand_contains_flush(const HandDistribution *dist) {
+    // Same carry trick as the rank lanes, with 8-bit suit lanes
+    // this allows MAX_SELECTION_SIZE - 1 for four fingers joker
+    return ((dist->suit_counts + SUIT_LANES_ONES * (0x80 - MAX_SELECTION_SIZE)) & SUIT_LANES_HIGH_BITS) != 0;
 }
 
-bool hand_contains_flush(u8 *suits) {
-    for (int i = 0; i < NUM_SUITS; i++)
-    {
-        if (suits[i] >= MAX_SELECTION_SIZE) // this allows MAX_SELECTION_SIZE - 1 for four fingers joker
-        {
-            return true;
+// The distribution is expected to hold at least one card
+ARM_IWRAM_CODE enum HandType hand_distribution_get_type(const HandDistribution *dist) {
+    enum HandType res_hand_type = HIGH_CARD;
+
+    // Check for flush
+    if (hand_contains_flush(dist))
+        res_hand_type = FLUSH;
+
+    // Check for straight
+    if (hand_contains_straight(dist)) {
+        if (res_hand_type == FLUSH)
+            res_hand_type = STRAIGHT_FLUSH;
+        else
+            res_hand_type = STRAIGHT;
+    }
+
+    // Check for royal flush vs regular straight flush
+    if (res_hand_type == STRAIGHT_FLUSH) {
+        if (hand_contains_royal(dist))
+            return ROYAL_FLUSH;
+        return STRAIGHT_FLUSH;
+    }
+
+    // The following can be optimized better but not sure how much it matters
+    u8 n_of_a_kind = hand_contains_n_of_a_kind(dist);
+
+    if (n_of_a_kind >= 5) {
+        if (res_hand_type == FLUSH) {
+            return FLUSH_FIVE;
         }
+        return FIVE_OF_A_KIND;
     }
-    return false;
+
+    if (n_of_a_kind == 4) {
+        return FOUR_OF_A_KIND;
+    }
+
+    if (n_of_a_kind == 3 && hand_contains_full_house(dist)) {
+        return FULL_HOUSE;
+    }
+
+    // Flush is more valuable than the remaining hand types, so return now
+    if (res_hand_type == FLUSH) {
+        return FLUSH;
+    }
+
+    if (n_of_a_kind == 3) {
+        return THREE_OF_A_KIND;
+    }
+
+    if (n_of_a_kind == 2) {
+        if (hand_contains_two_pair(dist)) {
+            return TWO_PAIR;
+        }
+        return PAIR;
+    }
+
+    return res_hand_type; // should be HIGH_CARD
 }
+
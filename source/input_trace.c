@@ -0,0 +1,184 @@
+#include "input_trace.h"
+
+#if defined(INPUT_RECORD) || defined(INPUT_REPLAY)
+
+#include "mgba_log.h"
+
+// SRAM is on an 8-bit bus, everything is read and written a byte at a time
+#define TRACE_SRAM ((vu8 *)(MEM_SRAM + INPUT_TRACE_SRAM_OFFSET))
+
+#define TRACE_MAGIC 0x31435254 // "TRC1"
+
+// Byte offsets in the trace
+#define TRACE_MAGIC_OFFSET       0
+#define TRACE_NUM_ENTRIES_OFFSET 4
+#define TRACE_NUM_SEEDS_OFFSET   8
+#define TRACE_SEEDS_OFFSET       12
+#define TRACE_ENTRIES_OFFSET     (TRACE_SEEDS_OFFSET + INPUT_TRACE_MAX_SEEDS * 4)
+#define TRACE_MAX_ENTRIES        ((INPUT_TRACE_SRAM_SIZE - TRACE_ENTRIES_OFFSET) / 2)
+
+#define ENTRY_RUN_SHIFT 10
+#define ENTRY_MAX_RUN   (1 << (16 - ENTRY_RUN_SHIFT))
+#define ENTRY(keys, run) ((keys) | (((run) - 1) << ENTRY_RUN_SHIFT))
+#define ENTRY_KEYS(entry) ((entry) & KEY_MASK)
+#define ENTRY_RUN(entry) (((entry) >> ENTRY_RUN_SHIFT) + 1)
+
+static u32 num_entries = 0;
+static u32 num_seeds = 0;
+static u32 frame = 0;
+
+#ifdef INPUT_RECORD
+
+static void sram_write(int offset, int size, u32 value)
+{
+    for (int i = 0; i < size; i++)
+    {
+        TRACE_SRAM[offset + i] = value >> (i * 8);
+    }
+}
+
+static u16 run_keys = 0;
+static int run_len = 0; // Frames in the last entry so far
+
+void input_trace_init(void)
+{
+    num_entries = 0;
+    num_seeds = 0;
+    sram_write(TRACE_NUM_ENTRIES_OFFSET, 4, 0);
+    sram_write(TRACE_NUM_SEEDS_OFFSET, 4, 0);
+    sram_write(TRACE_MAGIC_OFFSET, 4, TRACE_MAGIC);
+    mgba_log_init();
+}
+
+void input_trace_key_poll(void)
+{
+    key_poll();
+    frame++;
+
+    u16 keys = key_curr_state();
+    if (num_entries > 0 && keys == run_keys && run_len < ENTRY_MAX_RUN)
+    {
+        run_len++;
+    }
+    else if (num_entries < TRACE_MAX_ENTRIES)
+    {
+        run_keys = keys;
+        run_len = 1;
+        num_entries++;
+        sram_write(TRACE_NUM_ENTRIES_OFFSET, 4, num_entries);
+        if (num_entries == TRACE_MAX_ENTRIES)
+        {
+            mgba_logf(MGBA_LOG_WARN, "record: trace full after %lu frames", (unsigned long)frame);
+        }
+    }
+    else
+    {
+        return;
+    }
+
+    // The last entry is rewritten every frame so the trace is complete whenever the game is closed
+    sram_write(TRACE_ENTRIES_OFFSET + (num_entries - 1) * 2, 2, ENTRY(run_keys, run_len));
+}
+
+u32 input_trace_seed(u32 seed)
+{
+    if (num_seeds < INPUT_TRACE_MAX_SEEDS)
+    {
+        sram_write(TRACE_SEEDS_OFFSET + num_seeds * 4, 4, seed);
+        num_seeds++;
+        sram_write(TRACE_NUM_SEEDS_OFFSET, 4, num_seeds);
+    }
+
+    mgba_logf(MGBA_LOG_INFO, "record: seed %lu at frame %lu", (unsigned long)seed, (unsigned long)frame);
+    return seed;
+}
+
+#else // INPUT_REPLAY
+
+static u32 sram_read(int offset, int size)
+{
+    u32 value = 0;
+    for (int i = 0; i < size; i++)
+    {
+        value |= (u32)TRACE_SRAM[offset + i] << (i * 8);
+    }
+    return value;
+}
+
+static u32 entry_idx = 0;
+static u32 seed_idx = 0;
+static int entry_frames_left = 0;
+static bool finished = false;
+
+void input_trace_init(void)
+{
+    mgba_log_init();
+
+    if (sram_read(TRACE_MAGIC_OFFSET, 4) != TRACE_MAGIC)
+    {
+        // Nothing to play, the first key_poll() stops
+        mgba_logf(MGBA_LOG_ERROR, "replay: no trace in SRAM");
+        return;
+    }
+
+    num_entries = min(sram_read(TRACE_NUM_ENTRIES_OFFSET, 4), TRACE_MAX_ENTRIES);
+    num_seeds = min(sram_read(TRACE_NUM_SEEDS_OFFSET, 4), INPUT_TRACE_MAX_SEEDS);
+    mgba_logf(MGBA_LOG_INFO, "replay: %lu entries, %lu seeds", (unsigned long)num_entries, (unsigned long)num_seeds);
+}
+
+void input_trace_key_poll(void)
+{
+    if (finished)
+    {
+        key_poll();
+        return;
+    }
+
+    if (entry_frames_left == 0)
+    {
+        if (entry_idx >= num_entries)
+        {
+            mgba_logf(MGBA_LOG_INFO, "replay: finished after %lu frames", (unsigned long)frame);
+            finished = true;
+            Stop();
+            // Only back here if something woke the CPU up, carry on with the real keys
+            key_poll();
+            return;
+        }
+
+        u16 entry = sram_read(TRACE_ENTRIES_OFFSET + entry_idx * 2, 2);
+        entry_idx++;
+        entry_frames_left = ENTRY_RUN(entry);
+        __key_prev = __key_curr;
+        __key_curr = ENTRY_KEYS(entry);
+    }
+    else
+    {
+        __key_prev = __key_curr;
+    }
+
+    entry_frames_left--;
+    frame++;
+}
+
+u32 input_trace_seed(u32 seed)
+{
+    if (seed_idx >= num_seeds)
+    {
+        mgba_logf(MGBA_LOG_WARN, "replay: more seeds than recorded, keeping %lu", (unsigned long)seed);
+        return seed;
+    }
+
+    u32 recorded = sram_read(TRACE_SEEDS_OFFSET + seed_idx * 4, 4);
+    seed_idx++;
+    if (recorded != seed)
+    {
+        mgba_logf(MGBA_LOG_WARN, "replay: seed %lu at frame %lu, recorded %lu", (unsigned long)seed,
+                  (unsigned long)frame, (unsigned long)recorded);
+    }
+    return recorded;
+}
+
+#endif // INPUT_RECORD
+
+#endif // INPUT_RECORD || INPUT_REPLAY
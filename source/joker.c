@@ -6,6 +6,9 @@
 #include "card.h"
 #include "soundbank.h"
 #include "util.h"
+#include "tile_cache.h"
+#include "pal_bank.h"
+#include "counter.h"
 
 #include <maxmod.h>
 #include <stdlib.h>
@@ -44,105 +47,39 @@ const static u8 edition_price_lut[MAX_EDITIONS] =
    since I'm lazy and sorting them wouldn't look good enough to warrant the effort.
 */
 static bool used_layers[MAX_JOKER_OBJECTS] = {false}; // Track used layers for joker sprites
-// TODO: Refactor sorting into SpriteObject?
-
-// Maps the spritesheet index to the palette bank index allocated to it.
-// Spritesheets that were not allocated are
-static int* joker_spritesheet_pb_map;
-static int joker_pb_num_sprite_users[JOKER_LAST_PB - JOKER_BASE_PB + 1] = { 0 };
-
-static int get_num_spritesheets()
-{
-    return (get_joker_registry_size() + NUM_JOKERS_PER_SPRITESHEET - 1) / NUM_JOKERS_PER_SPRITESHEET;
-}
 
-static int joker_get_spritesheet_idx(u8 joker_id)
-
-{
-    return joker_id / NUM_JOKERS_PER_SPRITESHEET;
-}
+POOL_DEFINE(Joker, joker_pool, MAX_JOKER_OBJECTS);
+POOL_DEFINE(JokerObject, joker_object_pool, MAX_JOKER_OBJECTS);
 
-// TODO: This should be generalized so any sprite can have dynamic swapping
-static void joker_pb_add_sprite_user(int pb)
+const Pool *joker_get_pool(void)
 {
-    joker_pb_num_sprite_users[pb - JOKER_BASE_PB]++;
+    return &joker_pool;
 }
 
-static void joker_pb_remove_sprite_user(int pb)
+const Pool *joker_object_get_pool(void)
 {
-    int num_sprite_users = joker_pb_num_sprite_users[pb - JOKER_BASE_PB];
-    joker_pb_num_sprite_users[pb - JOKER_BASE_PB] = max(0, num_sprite_users - 1);
-}
-
-static int joker_pb_get_num_sprite_users(int joker_pb)
-{
-    return joker_pb_num_sprite_users[joker_pb - JOKER_BASE_PB];
-}
-
-static int get_unused_joker_pb()
-{
-    for (int i = 0; i < NUM_ELEM_IN_ARR(joker_pb_num_sprite_users); i++)
-    {
-        if (joker_pb_num_sprite_users[i] == 0)
-        {
-            return (i + JOKER_BASE_PB);
-        }
-    }
-
-    return UNDEFINED;
+    return &joker_object_pool;
 }
+// TODO: Refactor sorting into SpriteObject?
 
-static int allocate_pb_if_needed(u8 joker_id)
-{
-    int joker_spritesheet_idx = joker_get_spritesheet_idx(joker_id);
-    int joker_pb = joker_spritesheet_pb_map[joker_spritesheet_idx];
-    if (joker_pb != UNDEFINED)
-    {
-        // Already allocated
-        return joker_pb;
-    }
-    
-    // Allocate a new palette
-    joker_pb = get_unused_joker_pb();
-
-    if (joker_pb == UNDEFINED)
-    {
-        // Ran out of palettes, default to base and pray
-        joker_pb = JOKER_BASE_PB;
-    }
-    else
-    {
-        joker_spritesheet_pb_map[joker_spritesheet_idx] = joker_pb;
-        memcpy16(&pal_obj_mem[PAL_ROW_LEN * joker_pb], joker_gfxPal[joker_spritesheet_idx], NUM_ELEM_IN_ARR(joker_gfx0Pal));
-    }
-    
-    return joker_pb;
-}
+static int joker_get_spritesheet_idx(u8 joker_id)
 
-void joker_init()
 {
-    // This should init once only so no need to free
-    int num_spritesheets = get_num_spritesheets();
-    joker_spritesheet_pb_map = (int*)malloc(sizeof(int) * num_spritesheets);
-
-    for (int i = 0; i < num_spritesheets; i++)
-    {
-        joker_spritesheet_pb_map[i] = UNDEFINED;
-    }
+    return joker_id / NUM_JOKERS_PER_SPRITESHEET;
 }
 
 Joker *joker_new(u8 id)
 {
     if (id >= get_joker_registry_size()) return NULL;
 
-    Joker *joker = (Joker*)malloc(sizeof(Joker));
+    Joker *joker = joker_pool_alloc();
+    if (joker == NULL) return NULL;
     const JokerInfo *jinfo = get_joker_registry_entry(id);
 
     joker->id = id;
     joker->modifier = BASE_EDITION; // TODO: Make this a parameter
     joker->value = jinfo->base_value + edition_price_lut[joker->modifier];
     joker->rarity = jinfo->rarity;
-    joker->processed = false;
 
     return joker;
 }
@@ -150,16 +87,42 @@ Joker *joker_new(u8 id)
 void joker_destroy(Joker **joker)
 {
     if (*joker == NULL) return;
-    free(*joker);
+    joker_pool_free(*joker);
     *joker = NULL;
 }
 
-JokerEffect joker_get_score_effect(Joker *joker, Card *scored_card)
+JokerEffect joker_get_score_effect(Joker *joker, Card *scored_card, const HandContext *hand_context)
 {
     const JokerInfo *jinfo = get_joker_registry_entry(joker->id);
     if (!jinfo || jinfo->effect == NULL) return (JokerEffect){0};
 
-    return jinfo->effect(joker, scored_card);
+    return jinfo->effect(joker, scored_card, hand_context);
+}
+
+void joker_dispatch_build(JokerDispatch *dispatch, Joker *jokers[], int num_jokers)
+{
+    dispatch->num_jokers = num_jokers;
+    for (int phase = 0; phase < JOKER_NUM_PHASES; phase++)
+    {
+        dispatch->num_entries[phase] = 0;
+    }
+
+    for (int i = 0; i < num_jokers && i < MAX_JOKERS_HELD_SIZE; i++)
+    {
+        const JokerInfo *jinfo = get_joker_registry_entry(jokers[i]->id);
+        if (!jinfo || jinfo->effect == NULL) continue;
+
+        for (int phase = 0; phase < JOKER_NUM_PHASES; phase++)
+        {
+            if (!(jinfo->phases & JOKER_PHASE_FLAG(phase))) continue;
+
+            JokerDispatchEntry *entry = &dispatch->entries[phase][dispatch->num_entries[phase]++];
+            entry->effect = jinfo->effect;
+            entry->joker = jokers[i];
+            entry->joker_idx = i;
+            entry->fixed_effect = NULL;
+        }
+    }
 }
 
 int joker_get_sell_value(const Joker* joker)
@@ -175,8 +138,12 @@ int joker_get_sell_value(const Joker* joker)
 // JokerObject methods
 JokerObject *joker_object_new(Joker *joker)
 {
-    JokerObject *joker_object = malloc(sizeof(JokerObject));
+    if (joker == NULL) return NULL;
 
+    JokerObject *joker_object = joker_object_pool_alloc();
+    if (joker_object == NULL) return NULL;
+
+    // There are as many layers as pool slots, so one is free
     int layer = 0;
     for (int i = 0; i < MAX_JOKER_OBJECTS; i++)
     {
@@ -190,15 +157,19 @@ JokerObject *joker_object_new(Joker *joker)
 
     joker_object->joker = joker;
     joker_object->sprite_object = sprite_object_new();
+    if (joker_object->sprite_object == NULL)
+    {
+        used_layers[layer] = false;
+        joker_object_pool_free(joker_object);
+        return NULL;
+    }
 
-    int tile_index = JOKER_TID + (layer * JOKER_SPRITE_OFFSET);
-    
     int joker_spritesheet_idx = joker_get_spritesheet_idx(joker->id);
     int joker_idx = joker->id % NUM_JOKERS_PER_SPRITESHEET;
-    int joker_pb = allocate_pb_if_needed(joker->id);
-    joker_pb_add_sprite_user(joker_pb);
+    int joker_pb = pal_bank_acquire(joker_gfxPal[joker_spritesheet_idx]);
 
-    memcpy32(&tile_mem[4][tile_index], &joker_gfxTiles[joker_spritesheet_idx][joker_idx * TILE_SIZE * JOKER_SPRITE_OFFSET], TILE_SIZE * JOKER_SPRITE_OFFSET);
+    int tile_index = tile_cache_acquire(TILE_CACHE_KEY(TILE_CACHE_JOKER, joker->id),
+                                        &joker_gfxTiles[joker_spritesheet_idx][joker_idx * TILE_SIZE * JOKER_SPRITE_OFFSET]);
 
     sprite_object_set_sprite
     (
@@ -213,7 +184,14 @@ JokerObject *joker_object_new(Joker *joker)
         )
     );
 
-    
+    // sprite_new() has released the palette bank and the tiles if it failed
+    if (joker_object_get_sprite(joker_object) == NULL)
+    {
+        used_layers[layer] = false;
+        sprite_object_destroy(&joker_object->sprite_object);
+        joker_object_pool_free(joker_object);
+        return NULL;
+    }
 
     return joker_object;
 }
@@ -223,16 +201,13 @@ void joker_object_destroy(JokerObject **joker_object)
     if (joker_object == NULL || *joker_object == NULL) return;
 
     int layer = sprite_get_layer(joker_object_get_sprite(*joker_object)) - JOKER_STARTING_LAYER;
-    used_layers[layer] = false;
-    joker_pb_remove_sprite_user(sprite_get_pb(joker_object_get_sprite(*joker_object)));
-    if (joker_pb_get_num_sprite_users((sprite_get_pb(joker_object_get_sprite(*joker_object)))) == 0)
+    if (layer >= 0) // Negative without a sprite
     {
-        joker_spritesheet_pb_map[joker_get_spritesheet_idx((*joker_object)->joker->id)] = UNDEFINED;
+        used_layers[layer] = false;
     }
-
     sprite_object_destroy(&(*joker_object)->sprite_object); // Destroy the sprite
     joker_destroy(&(*joker_object)->joker); // Destroy the joker
-    free(*joker_object);
+    joker_object_pool_free(*joker_object);
     *joker_object = NULL;
 }
 
@@ -247,68 +222,34 @@ void joker_object_shake(JokerObject *joker_object, mm_word sound_id)
     sprite_object_shake(joker_object->sprite_object, sound_id);
 }
 
-bool joker_object_score(JokerObject *joker_object, Card* scored_card, int *chips, int *mult, int *xmult, int *money, bool *retrigger)
+void joker_object_show_effect(JokerObject *joker_object, const JokerEffect *joker_effect)
 {
-    if (joker_object->joker->processed == true) return false; // If the joker has already been processed, return false
-
-    JokerEffect joker_effect = joker_get_score_effect(joker_object->joker, scored_card);
+    const int joker_score_display_offset_px = (MAX_CARD_SCORE_STR_LEN + 1)*TTE_CHAR_SIZE;
+    // + 1 For space
 
-    if (memcmp(&joker_effect, &(JokerEffect){0}, sizeof(JokerEffect)) != 0)
+    int cursorPosX = fx2int(joker_object->sprite_object->x) + 8; // Offset of 16 pixels to center the text on the card
+    if (joker_effect->chips > 0)
     {
-        *chips += joker_effect.chips;
-        *mult += joker_effect.mult;
-        *mult *= joker_effect.xmult > 0 ? joker_effect.xmult : 1; // if xmult is zero, DO NOT multiply by it
-        *money += joker_effect.money;
-        // TODO: Retrigger
-
-        const int joker_score_display_offset_px = (MAX_CARD_SCORE_STR_LEN + 1)*TTE_CHAR_SIZE;
-        // + 1 For space
-
-        int cursorPosX = fx2int(joker_object->sprite_object->x) + 8; // Offset of 16 pixels to center the text on the card
-        if (joker_effect.chips > 0)
-        {
-            char score_buffer[INT_MAX_DIGITS + 2]; // For '+' and null terminator
-            tte_set_pos(cursorPosX, JOKER_SCORE_TEXT_Y);
-            tte_set_special(0xD000); // Blue
-            snprintf(score_buffer, sizeof(score_buffer), "+%d", joker_effect.chips);
-            tte_write(score_buffer);
-            cursorPosX += joker_score_display_offset_px;
-        }
-        if (joker_effect.mult > 0)
-        {
-            char score_buffer[INT_MAX_DIGITS + 2];
-            tte_set_pos(cursorPosX, JOKER_SCORE_TEXT_Y);
-            tte_set_special(0xE000); // Red
-            snprintf(score_buffer, sizeof(score_buffer), "+%d", joker_effect.mult);
-            tte_write(score_buffer);
-            cursorPosX += joker_score_display_offset_px;
-        }
-        if (joker_effect.xmult > 0)
-        {
-            char score_buffer[INT_MAX_DIGITS + 2];
-            tte_set_pos(cursorPosX, JOKER_SCORE_TEXT_Y);
-            tte_set_special(0xE000); // Red
-            snprintf(score_buffer, sizeof(score_buffer), "X%d", joker_effect.xmult);
-            tte_write(score_buffer);
-            cursorPosX += joker_score_display_offset_px;
-        }
-        if (joker_effect.money > 0)
-        {
-            char score_buffer[INT_MAX_DIGITS + 2];
-            tte_set_pos(cursorPosX, JOKER_SCORE_TEXT_Y);
-            tte_set_special(0xC000); // Yellow
-            snprintf(score_buffer, sizeof(score_buffer), "+%d", joker_effect.money);
-            tte_write(score_buffer);
-            cursorPosX += joker_score_display_offset_px;
-        }
-
-        joker_object->joker->processed = true; // Mark the joker as processed
-        joker_object_shake(joker_object, SFX_CARD_SELECT); // TODO: Add a sound effect for scoring the joker
-
-        return true;
+        counter_draw_at(cursorPosX, JOKER_SCORE_TEXT_Y, TTE_BLUE_PB, '+', joker_effect->chips);
+        cursorPosX += joker_score_display_offset_px;
+    }
+    if (joker_effect->mult > 0)
+    {
+        counter_draw_at(cursorPosX, JOKER_SCORE_TEXT_Y, TTE_RED_PB, '+', joker_effect->mult);
+        cursorPosX += joker_score_display_offset_px;
+    }
+    if (joker_effect->xmult > 0)
+    {
+        counter_draw_at(cursorPosX, JOKER_SCORE_TEXT_Y, TTE_RED_PB, 'X', joker_effect->xmult);
+        cursorPosX += joker_score_display_offset_px;
+    }
+    if (joker_effect->money > 0)
+    {
+        counter_draw_at(cursorPosX, JOKER_SCORE_TEXT_Y, TTE_YELLOW_PB, '+', joker_effect->money);
+        cursorPosX += joker_score_display_offset_px;
     }
 
-    return false;
+    joker_object_shake(joker_object, SFX_CARD_SELECT); // TODO: Add a sound effect for scoring the joker
 }
 
 void joker_object_set_selected(JokerObject* joker_object, bool selected)
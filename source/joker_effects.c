@@ -3,199 +3,161 @@
 #include "util.h"
 #include "hand_analysis.h"
 #include "list.h"
+#include "rng.h"
 #include <stdlib.h>
 
-static JokerEffect default_joker_effect(Joker *joker, Card *scored_card) {
+/* The effects that only look at the cards are called for every scored card or hand
+ * and run as ARM code from IWRAM. The ones that call into the rest of the game stay in ROM.
+ */
+ARM_IWRAM_CODE static JokerEffect default_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card == NULL) effect.mult = 4;
     return effect;
 }
 
-static JokerEffect sinful_joker_effect(Card *scored_card, u8 sinful_suit) {
+static inline JokerEffect sinful_joker_effect(Card *scored_card, u8 sinful_suit) {
     JokerEffect effect = {0};
     if (scored_card != NULL && scored_card->suit == sinful_suit)
         effect.mult = 3;
     return effect;
 }
 
-static JokerEffect greedy_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect greedy_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     return sinful_joker_effect(scored_card, DIAMONDS);
 }
 
-static JokerEffect lusty_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect lusty_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     return sinful_joker_effect(scored_card, HEARTS);
 }
 
-static JokerEffect wrathful_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect wrathful_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     return sinful_joker_effect(scored_card, SPADES);
 }
 
-static JokerEffect gluttonous_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect gluttonous_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     return sinful_joker_effect(scored_card, CLUBS);
 }
 
-static JokerEffect jolly_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect jolly_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    // This is really inefficient but the only way at the moment to check for whole-hand conditions
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_played_distribution(ranks, suits);
-
-    if (hand_contains_n_of_a_kind(ranks) >= 2)
+    if (hand_contains_n_of_a_kind(&hand_context->distribution) >= 2)
         effect.mult = 8;
     return effect;
 }
 
-static JokerEffect zany_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect zany_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_played_distribution(ranks, suits);
-
-    if (hand_contains_n_of_a_kind(ranks) >= 3)
+    if (hand_contains_n_of_a_kind(&hand_context->distribution) >= 3)
         effect.mult = 12;
     return effect;
 }
 
-static JokerEffect mad_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect mad_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_played_distribution(ranks, suits);
-
-    if (hand_contains_two_pair(ranks))
+    if (hand_contains_two_pair(&hand_context->distribution))
         effect.mult = 10;
     return effect;
 }
 
-static JokerEffect crazy_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect crazy_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_played_distribution(ranks, suits);
-
-    if (hand_contains_straight(ranks))
+    if (hand_contains_straight(&hand_context->distribution))
         effect.mult = 12;
     return effect;
 }
 
-static JokerEffect droll_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect droll_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_played_distribution(ranks, suits);
-
-    if (hand_contains_flush(suits))
+    if (hand_contains_flush(&hand_context->distribution))
         effect.mult = 10;
     return effect;
 }
 
-static JokerEffect sly_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect sly_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_played_distribution(ranks, suits);
-
-    if (hand_contains_n_of_a_kind(ranks) >= 2)
+    if (hand_contains_n_of_a_kind(&hand_context->distribution) >= 2)
         effect.chips = 50;
     return effect;
 }
 
-static JokerEffect wily_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect wily_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_played_distribution(ranks, suits);
-
-    if (hand_contains_n_of_a_kind(ranks) >= 3)
+    if (hand_contains_n_of_a_kind(&hand_context->distribution) >= 3)
         effect.chips = 100;
     return effect;
 }
 
-static JokerEffect clever_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect clever_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_played_distribution(ranks, suits);
-
-    if (hand_contains_two_pair(ranks))
+    if (hand_contains_two_pair(&hand_context->distribution))
         effect.chips = 80;
     return effect;
 }
 
-static JokerEffect devious_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect devious_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_played_distribution(ranks, suits);
-
-    if (hand_contains_straight(ranks))
+    if (hand_contains_straight(&hand_context->distribution))
         effect.chips = 100;
     return effect;
 }
 
-static JokerEffect crafty_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect crafty_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_played_distribution(ranks, suits);
-
-    if (hand_contains_flush(suits))
+    if (hand_contains_flush(&hand_context->distribution))
         effect.chips = 80;
     return effect;
 }
 
-static JokerEffect half_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect half_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    int played_size = get_played_top() + 1;
-    if (played_size <= 3) 
+    if (hand_context->played_count <= 3)
         effect.mult = 20;
 
     return effect;
 }
 
-static JokerEffect joker_stencil_effect(Joker *joker, Card *scored_card) {
+static JokerEffect joker_stencil_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    List* jokers = get_jokers();
+    const JokerObjectList* jokers = get_jokers();
 
     // +1 xmult per empty joker slot...
-    int num_jokers = list_get_size(jokers);
+    int num_jokers = jokers->size;
 
     effect.xmult = (MAX_JOKERS_HELD_SIZE) - num_jokers;
 
@@ -203,8 +165,7 @@ static JokerEffect joker_stencil_effect(Joker *joker, Card *scored_card) {
     
     for (int i = 0; i < num_jokers; i++ )
     {
-        JokerObject* joker_object = list_get(jokers, i);
-        if (joker_object->joker->id == JOKER_STENCIL_ID)
+        if (jokers->items[i]->joker->id == JOKER_STENCIL_ID)
             effect.xmult++;
     }
 
@@ -212,17 +173,17 @@ static JokerEffect joker_stencil_effect(Joker *joker, Card *scored_card) {
 }
 
 #define MISPRINT_MAX_MULT 23
-static JokerEffect misprint_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect misprint_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    effect.mult = random() % (MISPRINT_MAX_MULT + 1);
+    effect.mult = rng_range(RNG_JOKER, MISPRINT_MAX_MULT + 1);
 
     return effect;
 }
 
-static JokerEffect walkie_talkie_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect walkie_talkie_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card == NULL)
         return effect;
@@ -235,7 +196,7 @@ static JokerEffect walkie_talkie_joker_effect(Joker *joker, Card *scored_card) {
     return effect;
 }
 
-static JokerEffect fibonnaci_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect fibonnaci_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card == NULL)
         return effect;
@@ -250,7 +211,7 @@ static JokerEffect fibonnaci_joker_effect(Joker *joker, Card *scored_card) {
     return effect;
 }
 
-static JokerEffect banner_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect banner_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
@@ -260,7 +221,7 @@ static JokerEffect banner_joker_effect(Joker *joker, Card *scored_card) {
     return effect;
 }
 
-static JokerEffect mystic_summit_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect mystic_summit_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
@@ -271,17 +232,15 @@ static JokerEffect mystic_summit_joker_effect(Joker *joker, Card *scored_card) {
     return effect;
 }
 
-static JokerEffect blackboard_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect blackboard_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
     bool all_cards_are_spades_or_clubs = true;
-    CardObject** hand = get_hand_array();
-    int hand_size = hand_get_size();
-    for (int i = 0; i < hand_size; i++ )
+    for (int i = 0; i < hand_context->held_count; i++ )
     {
-        u8 suit = hand[i]->card->suit;
+        u8 suit = hand_context->held_cards[i]->suit;
         if (suit == HEARTS || suit == DIAMONDS) {
             all_cards_are_spades_or_clubs = false;
             break;
@@ -294,7 +253,7 @@ static JokerEffect blackboard_joker_effect(Joker *joker, Card *scored_card) {
     return effect;
 }
 
-static JokerEffect blue_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect blue_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
@@ -304,7 +263,7 @@ static JokerEffect blue_joker_effect(Joker *joker, Card *scored_card) {
     return effect;
 }
 
-static JokerEffect raised_fist_joker_effect(Joker *joker, Card *scored_card) 
+ARM_IWRAM_CODE static JokerEffect raised_fist_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) 
 {
     JokerEffect effect = {0};
     if (scored_card != NULL)
@@ -313,11 +272,9 @@ static JokerEffect raised_fist_joker_effect(Joker *joker, Card *scored_card)
     // Find the lowest rank card in hand
     // Aces are always considered high value, even in an ace-low straight
     u8 lowest_value = IMPOSSIBLY_HIGH_CARD_VALUE;
-    CardObject** hand = get_hand_array();
-    int hand_size = hand_get_size();
-    for (int i = 0; i < hand_size; i++ )
+    for (int i = 0; i < hand_context->held_count; i++ )
     {
-        u8 value = card_get_value(hand[i]->card);
+        u8 value = card_get_value(hand_context->held_cards[i]);
         if (lowest_value > value)
             lowest_value = value;
     }
@@ -328,16 +285,14 @@ static JokerEffect raised_fist_joker_effect(Joker *joker, Card *scored_card)
     return effect;
 } 
 
-static JokerEffect reserved_parking_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect reserved_parking_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    CardObject** hand = get_hand_array();
-    int hand_size = hand_get_size();
-    for (int i = 0; i < hand_size; i++ )
+    for (int i = 0; i < hand_context->held_count; i++ )
     {
-        if ((random() % 2 == 0) && card_is_face(hand[i]->card)) {
+        if (card_is_face(hand_context->held_cards[i]) && rng_coin_flip(RNG_JOKER)) {
             effect.money += 1;
         }
     }
@@ -345,19 +300,19 @@ static JokerEffect reserved_parking_joker_effect(Joker *joker, Card *scored_card
     return effect;
 };
 
-static JokerEffect business_card_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect business_card_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card == NULL)
         return effect;
 
-    if ((random() % 2 == 0) && card_is_face(scored_card)) {
+    if (card_is_face(scored_card) && rng_coin_flip(RNG_JOKER)) {
         effect.money = 2;
     }
 
     return effect;
 }
 
-static JokerEffect scholar_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect scholar_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card == NULL)
         return effect;
@@ -370,7 +325,7 @@ static JokerEffect scholar_joker_effect(Joker *joker, Card *scored_card) {
     return effect;
 }
 
-static JokerEffect scary_face_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect scary_face_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card == NULL)
         return effect;
@@ -382,29 +337,29 @@ static JokerEffect scary_face_joker_effect(Joker *joker, Card *scored_card) {
     return effect;
 }
 
-static JokerEffect abstract_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect abstract_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
     // +1 xmult per occupied joker slot
-    int num_jokers = list_get_size(get_jokers());
+    int num_jokers = get_jokers()->size;
     effect.mult = num_jokers * 3;
 
     return effect;
 }
 
-static JokerEffect bull_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect bull_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    effect.chips = get_money() * 2;
+    effect.chips = hand_context_get_money(hand_context) * 2;
 
     return effect;
 }
 
-static JokerEffect smiley_face_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect smiley_face_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card == NULL)
         return effect;
@@ -416,7 +371,7 @@ static JokerEffect smiley_face_joker_effect(Joker *joker, Card *scored_card) {
     return effect;
 }
 
-static JokerEffect even_steven_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect even_steven_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card == NULL)
         return effect;
@@ -433,7 +388,7 @@ static JokerEffect even_steven_joker_effect(Joker *joker, Card *scored_card) {
     return effect;
 }
 
-static JokerEffect odd_todd_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect odd_todd_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card == NULL)
         return effect;
@@ -445,7 +400,7 @@ static JokerEffect odd_todd_joker_effect(Joker *joker, Card *scored_card) {
 }
 
 __attribute__((unused))
-static JokerEffect acrobat_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect acrobat_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card == NULL)
         return effect;
@@ -458,85 +413,62 @@ static JokerEffect acrobat_joker_effect(Joker *joker, Card *scored_card) {
     return effect;
 }
 
-static JokerEffect the_duo_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect the_duo_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
     
-     // This is really inefficient but the only way at the moment to check for whole-hand conditions
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_played_distribution(ranks, suits);
-
-    if (hand_contains_n_of_a_kind(ranks) >= 2)
+    if (hand_contains_n_of_a_kind(&hand_context->distribution) >= 2)
         effect.xmult = 2;
     return effect;
  }
 
-static JokerEffect the_trio_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect the_trio_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
     
-     // This is really inefficient but the only way at the moment to check for whole-hand conditions
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_played_distribution(ranks, suits);
-
-    if (hand_contains_n_of_a_kind(ranks) >= 3)
+    if (hand_contains_n_of_a_kind(&hand_context->distribution) >= 3)
         effect.xmult = 3;
     return effect;
  }
 
-static JokerEffect the_family_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect the_family_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
     
-     // This is really inefficient but the only way at the moment to check for whole-hand conditions
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_played_distribution(ranks, suits);
-
-    if (hand_contains_n_of_a_kind(ranks) >= 4)
+    if (hand_contains_n_of_a_kind(&hand_context->distribution) >= 4)
         effect.xmult = 4;
     return effect;
  }
 
-static JokerEffect the_order_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect the_order_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_played_distribution(ranks, suits);
-
-    if (hand_contains_straight(ranks))
+    if (hand_contains_straight(&hand_context->distribution))
         effect.xmult = 3;
     return effect;
 }
 
-static JokerEffect the_tribe_joker_effect(Joker *joker, Card *scored_card) {
+ARM_IWRAM_CODE static JokerEffect the_tribe_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    u8 suits[NUM_SUITS];
-    u8 ranks[NUM_RANKS];
-    get_played_distribution(ranks, suits);
-
-    if (hand_contains_flush(suits))
+    if (hand_contains_flush(&hand_context->distribution))
         effect.xmult = 2;
     return effect;
 }
 
-static JokerEffect bootstraps_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect bootstraps_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
 
-    effect.mult = (get_money() / 5) * 2;
+    effect.mult = (hand_context_get_money(hand_context) / 5) * 2;
 
     return effect;
 }
@@ -545,16 +477,14 @@ static JokerEffect bootstraps_joker_effect(Joker *joker, Card *scored_card) {
 // Remove the attribute once they have sprites
 // no graphics available but ready to be used if wanted when graphics available
 __attribute__((unused))
-static JokerEffect shoot_the_moon_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect shoot_the_moon_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card != NULL)
         return effect; // if card != null, we are not at the end-phase of scoring yet
         
-    CardObject** hand = get_hand_array();
-    int hand_size = hand_get_size();
-    for (int i = 0; i < hand_size; i++ )
+    for (int i = 0; i < hand_context->held_count; i++ )
     {
-        if (hand[i]->card->rank == QUEEN)
+        if (hand_context->held_cards[i]->rank == QUEEN)
         {
              effect.mult += 13;
         }
@@ -565,7 +495,7 @@ static JokerEffect shoot_the_moon_joker_effect(Joker *joker, Card *scored_card)
 
 // no graphics available but ready to be used if wanted when graphics available
 __attribute__((unused))
-static JokerEffect triboulet_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect triboulet_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     if (scored_card == NULL)
         return effect;
@@ -580,16 +510,15 @@ static JokerEffect triboulet_joker_effect(Joker *joker, Card *scored_card) {
     return effect;
 }
 
-static JokerEffect blueprint_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect blueprint_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
-    List* jokers = get_jokers();
-    int list_size = list_get_size(jokers);
+    const JokerObjectList* jokers = get_jokers();
     
-    for (int i = 0; i < list_size  - 1; i++ ) {
-        JokerObject* curr_joker_object = list_get(jokers, i);
+    for (int i = 0; i < jokers->size - 1; i++ ) {
+        JokerObject* curr_joker_object = jokers->items[i];
         if (curr_joker_object->joker == joker) {
-            JokerObject* next_joker_object = list_get(jokers, i + 1);
-            effect = joker_get_score_effect(next_joker_object->joker, scored_card);
+            JokerObject* next_joker_object = jokers->items[i + 1];
+            effect = joker_get_score_effect(next_joker_object->joker, scored_card, hand_context);
             break;
         }
     }
@@ -597,19 +526,19 @@ static JokerEffect blueprint_joker_effect(Joker *joker, Card *scored_card) {
     return effect;
 }
 
-static JokerEffect brainstorm_joker_effect(Joker *joker, Card *scored_card) {
+static JokerEffect brainstorm_joker_effect(Joker *joker, Card *scored_card, const HandContext *hand_context) {
     JokerEffect effect = {0};
     static bool in_brainstorm = false;
     if (in_brainstorm)
         return effect;
 
-    List* jokers = get_jokers();
-    JokerObject* first_joker = list_get(jokers, 0);
+    const JokerObjectList* jokers = get_jokers();
+    JokerObject* first_joker = jokers->size > 0 ? jokers->items[0] : NULL;
 
     if (first_joker != NULL && first_joker->joker->id != JOKER_BRAINSTORM_ID) {
         // Static var to avoid infinite blueprint + brainstorm loops
         in_brainstorm = true;
-        effect = joker_get_score_effect(first_joker->joker, scored_card);
+        effect = joker_get_score_effect(first_joker->joker, scored_card, hand_context);
         in_brainstorm = false;
     }
 
@@ -626,61 +555,62 @@ static JokerEffect brainstorm_joker_effect(Joker *joker, Card *scored_card) {
  * Otherwise the order is similar to the wiki.
  */
 const JokerInfo joker_registry[] = {
-    { COMMON_JOKER, 2, default_joker_effect },  // DEFAULT_JOKER_ID = 0
-    { COMMON_JOKER, 5, greedy_joker_effect },   // GREEDY_JOKER_ID  = 1
-    { COMMON_JOKER, 5, lusty_joker_effect },    // etc...  2  
-    { COMMON_JOKER, 5, wrathful_joker_effect },         // 3                  
-    { COMMON_JOKER, 5, gluttonous_joker_effect },       // 4               
-    { COMMON_JOKER, 3, jolly_joker_effect },            // 5              
-    { COMMON_JOKER, 4, zany_joker_effect },             // 6
-    { COMMON_JOKER, 4, mad_joker_effect },              // 7
-    { COMMON_JOKER, 4, crazy_joker_effect },            // 8
-    { COMMON_JOKER, 4, droll_joker_effect },            // 9
-    { COMMON_JOKER, 3, sly_joker_effect },              // 10
-    { COMMON_JOKER, 4, wily_joker_effect },             // 11
-    { COMMON_JOKER, 4, clever_joker_effect },           // 12 
-    { COMMON_JOKER, 4, devious_joker_effect },          // 13 
-    { COMMON_JOKER, 4, crafty_joker_effect },           // 14
-    { COMMON_JOKER, 5, half_joker_effect },             // 15
-    { UNCOMMON_JOKER, 8, joker_stencil_effect },        // 16
-    { COMMON_JOKER, 5, banner_joker_effect },           // 17
-    { COMMON_JOKER, 4, walkie_talkie_joker_effect },    // 18
-    { UNCOMMON_JOKER, 8, fibonnaci_joker_effect },      // 19
-    { UNCOMMON_JOKER, 6, blackboard_joker_effect },     // 20
-    { COMMON_JOKER, 5, mystic_summit_joker_effect },    // 21
-    { COMMON_JOKER, 4, misprint_joker_effect },         // 22 
-    { COMMON_JOKER, 4, even_steven_joker_effect },      // 23
-    { COMMON_JOKER, 5, blue_joker_effect },             // 24
-    { COMMON_JOKER, 4, odd_todd_joker_effect },         // 25
-    { COMMON_JOKER, 4, scholar_joker_effect },          // 26
-    { COMMON_JOKER, 4, business_card_joker_effect },    // 27
+    { COMMON_JOKER, 2, JOKER_INDEPENDENT | JOKER_PLAY_INVARIANT, default_joker_effect },  // DEFAULT_JOKER_ID = 0
+    { COMMON_JOKER, 5, JOKER_ON_SCORED, greedy_joker_effect },   // GREEDY_JOKER_ID  = 1
+    { COMMON_JOKER, 5, JOKER_ON_SCORED, lusty_joker_effect },    // etc...  2  
+    { COMMON_JOKER, 5, JOKER_ON_SCORED, wrathful_joker_effect },         // 3                  
+    { COMMON_JOKER, 5, JOKER_ON_SCORED, gluttonous_joker_effect },       // 4               
+    { COMMON_JOKER, 3, JOKER_INDEPENDENT, jolly_joker_effect },            // 5              
+    { COMMON_JOKER, 4, JOKER_INDEPENDENT, zany_joker_effect },             // 6
+    { COMMON_JOKER, 4, JOKER_INDEPENDENT, mad_joker_effect },              // 7
+    { COMMON_JOKER, 4, JOKER_INDEPENDENT, crazy_joker_effect },            // 8
+    { COMMON_JOKER, 4, JOKER_INDEPENDENT, droll_joker_effect },            // 9
+    { COMMON_JOKER, 3, JOKER_INDEPENDENT, sly_joker_effect },              // 10
+    { COMMON_JOKER, 4, JOKER_INDEPENDENT, wily_joker_effect },             // 11
+    { COMMON_JOKER, 4, JOKER_INDEPENDENT, clever_joker_effect },           // 12 
+    { COMMON_JOKER, 4, JOKER_INDEPENDENT, devious_joker_effect },          // 13 
+    { COMMON_JOKER, 4, JOKER_INDEPENDENT, crafty_joker_effect },           // 14
+    { COMMON_JOKER, 5, JOKER_INDEPENDENT, half_joker_effect },             // 15
+    { UNCOMMON_JOKER, 8, JOKER_INDEPENDENT | JOKER_PLAY_INVARIANT, joker_stencil_effect },        // 16
+    { COMMON_JOKER, 5, JOKER_INDEPENDENT | JOKER_PLAY_INVARIANT, banner_joker_effect },           // 17
+    { COMMON_JOKER, 4, JOKER_ON_SCORED, walkie_talkie_joker_effect },    // 18
+    { UNCOMMON_JOKER, 8, JOKER_ON_SCORED, fibonnaci_joker_effect },      // 19
+    { UNCOMMON_JOKER, 6, JOKER_HELD | JOKER_INDEPENDENT, blackboard_joker_effect },     // 20
+    { COMMON_JOKER, 5, JOKER_INDEPENDENT | JOKER_PLAY_INVARIANT, mystic_summit_joker_effect },    // 21
+    { COMMON_JOKER, 4, JOKER_INDEPENDENT, misprint_joker_effect },         // 22 
+    { COMMON_JOKER, 4, JOKER_ON_SCORED, even_steven_joker_effect },      // 23
+    { COMMON_JOKER, 5, JOKER_INDEPENDENT | JOKER_PLAY_INVARIANT, blue_joker_effect },             // 24
+    { COMMON_JOKER, 4, JOKER_ON_SCORED, odd_todd_joker_effect },         // 25
+    { COMMON_JOKER, 4, JOKER_ON_SCORED, scholar_joker_effect },          // 26
+    { COMMON_JOKER, 4, JOKER_ON_SCORED, business_card_joker_effect },    // 27
     // Business card should be paired with Shortcut for palette optimization when it's added
-    { COMMON_JOKER, 4, scary_face_joker_effect },       // 28
-    { UNCOMMON_JOKER, 7, bootstraps_joker_effect},      // 29
-    { UNCOMMON_JOKER, 5, NULL /* Pareidolia */ },       // 30
-    { COMMON_JOKER, 6, reserved_parking_joker_effect }, // 31
-    { COMMON_JOKER, 4, abstract_joker_effect },         // 32
-    { UNCOMMON_JOKER, 6, bull_joker_effect},            // 33
-    { RARE_JOKER, 8, the_duo_joker_effect},             // 34
-    { RARE_JOKER, 8, the_trio_joker_effect},            // 35
-    { RARE_JOKER, 8, the_family_joker_effect},          // 36
-    { RARE_JOKER, 8, the_order_joker_effect},           // 37
-    { RARE_JOKER, 8, the_tribe_joker_effect},           // 38
-    { RARE_JOKER, 10, blueprint_joker_effect },         // 39
-    { RARE_JOKER, 10, brainstorm_joker_effect },        // 40
-    { COMMON_JOKER, 5, raised_fist_joker_effect },      // 41
-    { COMMON_JOKER, 4, smiley_face_joker_effect },      // 42
+    { COMMON_JOKER, 4, JOKER_ON_SCORED, scary_face_joker_effect },       // 28
+    { UNCOMMON_JOKER, 7, JOKER_INDEPENDENT, bootstraps_joker_effect },      // 29
+    { UNCOMMON_JOKER, 5, 0, NULL /* Pareidolia */ },       // 30
+    { COMMON_JOKER, 6, JOKER_HELD | JOKER_INDEPENDENT, reserved_parking_joker_effect }, // 31
+    { COMMON_JOKER, 4, JOKER_INDEPENDENT | JOKER_PLAY_INVARIANT, abstract_joker_effect },         // 32
+    { UNCOMMON_JOKER, 6, JOKER_INDEPENDENT, bull_joker_effect },            // 33
+    { RARE_JOKER, 8, JOKER_INDEPENDENT, the_duo_joker_effect },             // 34
+    { RARE_JOKER, 8, JOKER_INDEPENDENT, the_trio_joker_effect },            // 35
+    { RARE_JOKER, 8, JOKER_INDEPENDENT, the_family_joker_effect },          // 36
+    { RARE_JOKER, 8, JOKER_INDEPENDENT, the_order_joker_effect },           // 37
+    { RARE_JOKER, 8, JOKER_INDEPENDENT, the_tribe_joker_effect },           // 38
+    { RARE_JOKER, 10, JOKER_ALL_PHASES, blueprint_joker_effect },         // 39
+    { RARE_JOKER, 10, JOKER_ALL_PHASES, brainstorm_joker_effect },        // 40
+    { COMMON_JOKER, 5, JOKER_HELD | JOKER_INDEPENDENT, raised_fist_joker_effect },      // 41
+    { COMMON_JOKER, 4, JOKER_ON_SCORED, smiley_face_joker_effect },      // 42
 
     // The following jokers don't have sprites yet, 
     // uncomment them when their sprites are added.
 #if 0
 
-    { UNCOMMON_JOKER, 6, acrobat_joker_effect },
-    { COMMON_JOKER, 5, shoot_the_moon_joker_effect},
+    { UNCOMMON_JOKER, 6, JOKER_ON_SCORED, acrobat_joker_effect },
+    { COMMON_JOKER, 5, JOKER_HELD | JOKER_INDEPENDENT, shoot_the_moon_joker_effect },
 #endif
 };
 
 static const size_t joker_registry_size = NUM_ELEM_IN_ARR(joker_registry);
+_Static_assert(NUM_ELEM_IN_ARR(joker_registry) == NUM_JOKERS, "Update NUM_JOKERS in joker.h");
 
 const JokerInfo* get_joker_registry_entry(int joker_id) {
     if (joker_id < 0 || (size_t)joker_id >= joker_registry_size) {
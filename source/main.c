@@ -9,6 +9,11 @@
 #include "joker.h"
 #include "affine_background.h"
 #include "graphic_utils.h"
+#include "vram_queue.h"
+#include "profiler.h"
+#include "input_trace.h"
+#include "bench.h"
+#include "save.h"
 
 // Graphics
 #include "background_gfx.h"
@@ -22,7 +27,6 @@ void init()
 {
     irq_init(NULL);
     irq_add(II_VBLANK, mmVBlank);
-    irq_add(II_HBLANK, affine_background_hblank);
 
     // Initialize text engine
     tte_init_se(0, BG_CBB(TTE_CBB) | BG_SBB(TTE_SBB), 0, CLR_WHITE, TTE_BIT_UNPACK_OFFSET, NULL, NULL);
@@ -39,9 +43,9 @@ void init()
     // BG0 is the TTE text layer
     REG_BG0CNT = BG_PRIO(0) | BG_CBB(TTE_CBB) | BG_SBB(TTE_SBB) | BG_4BPP;
     // BG1 is the main background layer
-    REG_BG1CNT = BG_PRIO(1) | BG_CBB(MAIN_BG_CBB) | BG_SBB(MAIN_BG_SBB) | BG_8BPP;
+    REG_BG1CNT = BG_PRIO(1) | BG_SBB(MAIN_BG_SBB) | BG_8BPP; // The CBB is set by bg_assets_show()
 	// BG2 is the affine background layer
-    REG_BG2CNT = BG_PRIO(2) | BG_CBB(AFFINE_BG_CBB) | BG_SBB(AFFINE_BG_SBB) | BG_8BPP | BG_WRAP;
+    REG_BG2CNT = BG_PRIO(2) | BG_SBB(AFFINE_BG_SBB) | BG_8BPP | BG_WRAP;
 
     int win1_left = 72;
     int win1_top = 44;
@@ -73,34 +77,56 @@ void init()
     mmStart(MOD_MAIN_THEME, MM_PLAY_LOOP);
     affine_background_init();
     sprite_init();
-    card_init();
     blind_init();
-    joker_init();
     game_init();
+    PROFILE_INIT();
+    INPUT_TRACE_INIT();
 }
 
 void update()
 {
+    PROFILE_BEGIN(PROFILE_ZONE_AFFINE_BG);
     affine_background_update();
+    PROFILE_END(PROFILE_ZONE_AFFINE_BG);
+
+    PROFILE_BEGIN(PROFILE_ZONE_GAME);
     game_update();
+    PROFILE_END(PROFILE_ZONE_GAME);
+
+    PROFILE_BEGIN(PROFILE_ZONE_SAVE);
+    save_update();
+    PROFILE_END(PROFILE_ZONE_SAVE);
 }
 
 void draw()
 {
+    PROFILE_BEGIN(PROFILE_ZONE_SPRITE_DRAW);
     sprite_draw();
+    PROFILE_END(PROFILE_ZONE_SPRITE_DRAW);
 }
 
 int main()
 {
     init();
+    BENCH_RUN();
 
 	while(true)
     {
         VBlankIntrWait();
+        PROFILE_BEGIN(PROFILE_ZONE_VBLANK);
+        affine_background_vblank(); // Before line 0 starts drawing
+        vram_queue_flush(); // Early, while VBlank has the most time left
+        PROFILE_END(PROFILE_ZONE_VBLANK);
+        PROFILE_BEGIN(PROFILE_ZONE_AUDIO);
         mmFrame();
-		key_poll();
+        PROFILE_END(PROFILE_ZONE_AUDIO);
+        INPUT_TRACE_KEY_POLL();
+        PROFILE_FRAME(); // After key_poll() for the overlay toggle
         update();
         draw();
+        PROFILE_BEGIN(PROFILE_ZONE_IDLE);
+        game_idle();
+        PROFILE_END(PROFILE_ZONE_IDLE);
     }
 
 	return 0;
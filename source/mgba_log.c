@@ -0,0 +1,44 @@
+#include "mgba_log.h"
+
+#ifdef MGBA_LOG
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#define REG_DEBUG_ENABLE (*(vu16 *)0x4FFF780)
+#define REG_DEBUG_FLAGS  (*(vu16 *)0x4FFF700)
+#define REG_DEBUG_STRING ((char *)0x4FFF600)
+#define DEBUG_ENABLE_REQUEST 0xC0DE
+#define DEBUG_ENABLE_ACK     0x1DEA
+#define DEBUG_FLAG_SEND      0x100 // Prints the string with the level in the low bits
+
+static bool enabled = false;
+
+bool mgba_log_init(void)
+{
+    REG_DEBUG_ENABLE = DEBUG_ENABLE_REQUEST;
+    enabled = REG_DEBUG_ENABLE == DEBUG_ENABLE_ACK;
+    return enabled;
+}
+
+void mgba_logf(enum MgbaLogLevel level, const char *format, ...)
+{
+    if (!enabled)
+        return;
+
+    char line[MGBA_LOG_MAX_LEN];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    for (int i = 0; i < MGBA_LOG_MAX_LEN; i++)
+    {
+        REG_DEBUG_STRING[i] = line[i];
+        if (line[i] == '\0')
+            break;
+    }
+    REG_DEBUG_FLAGS = level | DEBUG_FLAG_SEND;
+}
+
+#endif // MGBA_LOG
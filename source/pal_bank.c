@@ -0,0 +1,108 @@
+#include "pal_bank.h"
+#include "graphic_utils.h"
+#include "util.h"
+#include "vram_queue.h"
+
+#include <string.h>
+
+typedef struct
+{
+    const u16 *palette; // NULL if the bank holds nothing
+    u16 refcount;
+    u32 last_release; // When the refcount last dropped to zero, for evicting the oldest first
+} PalBankSlot;
+
+static PalBankSlot slots[NUM_PALETTES];
+static u32 release_clock = 0;
+static PalBankStats stats = {0};
+
+void pal_bank_init(void)
+{
+    for (int i = 0; i < NUM_PALETTES; i++)
+    {
+        slots[i].palette = NULL;
+        slots[i].refcount = 0;
+        slots[i].last_release = 0;
+    }
+    release_clock = 0;
+}
+
+static int pal_bank_find(const u16 *palette)
+{
+    for (int i = 0; i < NUM_PALETTES; i++)
+    {
+        if (slots[i].palette == palette)
+            return i;
+    }
+
+    // Same colors from another array
+    for (int i = 0; i < NUM_PALETTES; i++)
+    {
+        if (slots[i].palette != NULL && memcmp(slots[i].palette, palette, PAL_ROW_LEN * sizeof(u16)) == 0)
+            return i;
+    }
+
+    return UNDEFINED;
+}
+
+int pal_bank_acquire(const u16 *palette)
+{
+    int pb = pal_bank_find(palette);
+    if (pb != UNDEFINED)
+    {
+        stats.hits++;
+        slots[pb].refcount++;
+        return pb;
+    }
+
+    // An empty bank if there is one, otherwise the unused bank released the longest ago
+    for (int i = 0; i < NUM_PALETTES; i++)
+    {
+        if (slots[i].refcount > 0)
+            continue;
+
+        if (slots[i].palette == NULL)
+        {
+            pb = i;
+            break;
+        }
+
+        if (pb == UNDEFINED || slots[i].last_release < slots[pb].last_release)
+        {
+            pb = i;
+        }
+    }
+
+    if (pb == UNDEFINED)
+    {
+        stats.failures++;
+        return UNDEFINED;
+    }
+
+    stats.misses++;
+    if (slots[pb].palette != NULL)
+    {
+        stats.evictions++;
+    }
+
+    slots[pb].palette = palette;
+    slots[pb].refcount = 1;
+    vram_queue_copy16(&pal_obj_bank[pb], palette, PAL_ROW_LEN);
+    return pb;
+}
+
+void pal_bank_release(int pb)
+{
+    if (pb < 0 || pb >= NUM_PALETTES || slots[pb].refcount == 0)
+        return;
+
+    if (--slots[pb].refcount == 0)
+    {
+        slots[pb].last_release = ++release_clock;
+    }
+}
+
+const PalBankStats *pal_bank_get_stats(void)
+{
+    return &stats;
+}
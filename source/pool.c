@@ -0,0 +1,69 @@
+#include "pool.h"
+
+#ifdef POOL_DEBUG
+#if defined(__arm__)
+#include "mgba_log.h"
+
+// The ROM has no stderr, the error goes to mGBA's log and the game halts where it went wrong
+static void pool_fail(const Pool *pool, const char *error)
+{
+    mgba_log_init();
+    mgba_logf(MGBA_LOG_ERROR, "pool %s: %s", pool->name, error);
+    while (true)
+    {
+        Stop();
+    }
+}
+#else
+#include <stdio.h>
+#include <stdlib.h>
+
+static void pool_fail(const Pool *pool, const char *error)
+{
+    fprintf(stderr, "pool %s: %s\n", pool->name, error);
+    abort();
+}
+#endif
+#endif
+
+void *pool_alloc(Pool *pool)
+{
+    int idx;
+    if (pool->num_free > 0)
+    {
+        idx = pool->free_indices[--pool->num_free];
+    }
+    else if (pool->num_used < pool->capacity)
+    {
+        idx = pool->num_used++;
+    }
+    else
+    {
+#ifdef POOL_DEBUG
+        pool_fail(pool, "out of slots");
+#endif
+        return NULL;
+    }
+
+#ifdef POOL_DEBUG
+    pool->in_use_bits[idx / 32] |= 1u << (idx % 32);
+#endif
+
+    return pool->storage + idx * pool->elem_size;
+}
+
+void pool_free_idx(Pool *pool, int idx)
+{
+#ifdef POOL_DEBUG
+    if (idx < 0 || idx >= pool->num_used)
+        pool_fail(pool, "freeing a pointer that isn't from this pool");
+
+    u32 bit = 1u << (idx % 32);
+    if (!(pool->in_use_bits[idx / 32] & bit))
+        pool_fail(pool, "double free");
+
+    pool->in_use_bits[idx / 32] &= ~bit;
+#endif
+
+    pool->free_indices[pool->num_free++] = idx;
+}
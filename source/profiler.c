@@ -0,0 +1,163 @@
+#include "profiler.h"
+
+#ifdef PROFILE
+
+#include "cycle_counter.h"
+#include "graphic_utils.h"
+#include "mgba_log.h"
+#include "util.h"
+
+#define OVERLAY_TOGGLE_HELD KEY_B
+#define OVERLAY_TOGGLE_HIT  KEY_START
+#define OVERLAY_RECT_LEFT   (12 * TTE_CHAR_SIZE)
+#define OVERLAY_RECT_RIGHT  SCREEN_WIDTH
+
+typedef struct
+{
+    const char *name;
+    bool nested; // Inside another zone, not added to the frame total
+} ProfileZoneInfo;
+
+static const ProfileZoneInfo zone_infos[PROFILE_ZONE_COUNT] =
+{
+    [PROFILE_ZONE_VBLANK]        = {"vblank",   false},
+    [PROFILE_ZONE_AUDIO]         = {"audio",    false},
+    [PROFILE_ZONE_AFFINE_BG]     = {"affinebg", false},
+    [PROFILE_ZONE_GAME]          = {"game",     false},
+    [PROFILE_ZONE_JOKERS]        = {" jokers",  true},
+    [PROFILE_ZONE_CARDS]         = {" cards",   true},
+    [PROFILE_ZONE_SPRITE_DRAW]   = {"sprites",  false},
+    [PROFILE_ZONE_SAVE]          = {"save",     false},
+    [PROFILE_ZONE_IDLE]          = {"idle",     false},
+    [PROFILE_ZONE_SPLASH_SCREEN] = {" splash",  true},
+    [PROFILE_ZONE_MAIN_MENU]     = {" menu",    true},
+    [PROFILE_ZONE_PLAYING]       = {" playing", true},
+    [PROFILE_ZONE_ROUND_END]     = {" rnd end", true},
+    [PROFILE_ZONE_SHOP]          = {" shop",    true},
+    [PROFILE_ZONE_BLIND_SELECT]  = {" blinds",  true},
+    [PROFILE_ZONE_LOSE]          = {" lose",    true},
+    [PROFILE_ZONE_WIN]           = {" win",     true},
+};
+
+typedef struct
+{
+    u32 min, avg, max;
+} ProfileZoneStats;
+
+static u32 zone_starts[PROFILE_ZONE_COUNT];
+static u32 zone_cycles[PROFILE_ZONE_COUNT]; // This frame's so far
+static EWRAM_BSS u32 history[PROFILE_HISTORY_LEN][PROFILE_ZONE_COUNT];
+static int history_pos = 0;
+static int history_len = 0;
+static uint frame = 0;
+static bool overlay_shown = false;
+
+void profiler_init(void)
+{
+    cycle_counter_init();
+    mgba_log_init();
+}
+
+void profiler_begin(enum ProfileZone zone)
+{
+    zone_starts[zone] = cycle_counter_read();
+}
+
+void profiler_end(enum ProfileZone zone)
+{
+    zone_cycles[zone] += cycle_counter_read() - zone_starts[zone];
+}
+
+static void profiler_get_stats(ProfileZoneStats stats[])
+{
+    for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++)
+    {
+        u32 min = UINT32_MAX, max = 0, sum = 0;
+        for (int i = 0; i < history_len; i++)
+        {
+            u32 cycles = history[i][zone];
+            min = cycles < min ? cycles : min;
+            max = cycles > max ? cycles : max;
+            sum += cycles;
+        }
+
+        stats[zone].min = history_len > 0 ? min : 0;
+        stats[zone].avg = history_len > 0 ? sum / history_len : 0;
+        stats[zone].max = max;
+    }
+}
+
+// In tenths of a percent of the frame
+static inline u32 profiler_frame_permille(u32 cycles)
+{
+    return cycles * 1000 / PROFILE_FRAME_CYCLES;
+}
+
+static void profiler_report(void)
+{
+    ProfileZoneStats stats[PROFILE_ZONE_COUNT];
+    profiler_get_stats(stats);
+
+    u32 total = 0;
+    for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++)
+    {
+        if (!zone_infos[zone].nested)
+        {
+            total += stats[zone].avg;
+        }
+    }
+
+    mgba_logf(MGBA_LOG_INFO, "profile: %u frames, avg total %lu cycles", frame, (unsigned long)total);
+    for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++)
+    {
+        u32 avg_permille = profiler_frame_permille(stats[zone].avg);
+        mgba_logf(MGBA_LOG_INFO, "profile: %-8s min %6lu avg %6lu max %6lu cycles, avg %lu.%lu%%",
+                  zone_infos[zone].name, (unsigned long)stats[zone].min, (unsigned long)stats[zone].avg,
+                  (unsigned long)stats[zone].max, (unsigned long)avg_permille / 10, (unsigned long)avg_permille % 10);
+    }
+
+    if (overlay_shown)
+    {
+        u32 total_permille = profiler_frame_permille(total);
+        tte_erase_rect(OVERLAY_RECT_LEFT, 0, OVERLAY_RECT_RIGHT, (PROFILE_ZONE_COUNT + 1) * TTE_CHAR_SIZE);
+        tte_printf("#{P:%d,0; cx:0x%X000}total %3lu.%lu%%", OVERLAY_RECT_LEFT, TTE_YELLOW_PB,
+                   (unsigned long)total_permille / 10, (unsigned long)total_permille % 10);
+
+        for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++)
+        {
+            u32 avg = profiler_frame_permille(stats[zone].avg);
+            u32 max = profiler_frame_permille(stats[zone].max);
+            tte_printf("#{P:%d,%d; cx:0x%X000}%-8s%3lu.%lu %3lu.%lu", OVERLAY_RECT_LEFT, (zone + 1) * TTE_CHAR_SIZE, TTE_WHITE_PB,
+                       zone_infos[zone].name, (unsigned long)avg / 10, (unsigned long)avg % 10,
+                       (unsigned long)max / 10, (unsigned long)max % 10);
+        }
+    }
+}
+
+void profiler_frame(void)
+{
+    for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++)
+    {
+        history[history_pos][zone] = zone_cycles[zone];
+        zone_cycles[zone] = 0;
+    }
+    history_pos = (history_pos + 1) % PROFILE_HISTORY_LEN;
+    history_len = min(history_len + 1, PROFILE_HISTORY_LEN);
+    frame++;
+
+    if (key_is_down(OVERLAY_TOGGLE_HELD) && key_hit(OVERLAY_TOGGLE_HIT))
+    {
+        overlay_shown = !overlay_shown;
+        if (!overlay_shown)
+        {
+            tte_erase_rect(OVERLAY_RECT_LEFT, 0, OVERLAY_RECT_RIGHT, (PROFILE_ZONE_COUNT + 1) * TTE_CHAR_SIZE);
+        }
+    }
+
+    if (frame % PROFILE_REPORT_PERIOD == 0)
+    {
+        profiler_report();
+    }
+}
+
+#endif // PROFILE
@@ -0,0 +1,58 @@
+#include "rng.h"
+
+// xorshift32 only needs shifts and xors, which are cheap on the ARM7
+static u32 rng_states[RNG_NUM_STREAMS] = {0};
+
+// splitmix32 style finalizer, spreads close seeds and stream indices over the whole state space
+static u32 rng_mix(u32 x)
+{
+    x ^= x >> 16;
+    x *= 0x7FEB352D;
+    x ^= x >> 15;
+    x *= 0x846CA68B;
+    x ^= x >> 16;
+    return x;
+}
+
+void rng_set_seed(u32 seed)
+{
+    for (int i = 0; i < RNG_NUM_STREAMS; i++)
+    {
+        // 0x9E3779B9 is the golden ratio increment, it keeps the streams apart for the same seed
+        u32 state = rng_mix(seed + (i + 1) * 0x9E3779B9);
+
+        // xorshift never leaves a zero state
+        rng_states[i] = state != 0 ? state : 1;
+    }
+}
+
+u32 rng_get_state(enum RngStream stream)
+{
+    return rng_states[stream];
+}
+
+void rng_set_state(enum RngStream stream, u32 state)
+{
+    rng_states[stream] = state;
+}
+
+u32 rng_next(enum RngStream stream)
+{
+    u32 x = rng_states[stream];
+
+    // A stream that was never seeded would only ever return 0
+    if (x == 0)
+        x = rng_mix(stream + 1);
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rng_states[stream] = x;
+    return x;
+}
+
+u32 rng_range(enum RngStream stream, u32 n)
+{
+    // The top 16 bits are the best mixed and keep the product within 32 bits
+    return ((rng_next(stream) >> 16) * n) >> 16;
+}
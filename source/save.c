@@ -0,0 +1,402 @@
+#include "save.h"
+
+#include <string.h>
+
+#include "util.h"
+
+// Tells emulators the cartridge has SRAM
+__attribute__((used))
+static const char sram_tag[] = "SRAM_V113";
+
+// SRAM is on an 8-bit bus, everything is read and written a byte at a time
+#define SAVE_SRAM ((vu8 *)(MEM_SRAM + SAVE_SRAM_OFFSET))
+
+#define NUM_SLOTS      2
+#define JOURNAL_OFFSET (NUM_SLOTS * SAVE_SLOT_SIZE)
+#define JOURNAL_SIZE   (SAVE_SRAM_SIZE - JOURNAL_OFFSET)
+
+#define SLOT_MAGIC    0x31565342 // "BSV1"
+#define JOURNAL_MAGIC 0x314E524A // "JRN1"
+
+// Byte offsets in a slot header. The image is written before the header and the checksum
+// before the sequence number, a slot that wasn't written completely never looks like the newest
+#define SLOT_CHECKSUM_OFFSET 0
+#define SLOT_VERSION_OFFSET  4
+#define SLOT_SIZE_OFFSET     6
+#define SLOT_SEQUENCE_OFFSET 8
+#define SLOT_MAGIC_OFFSET    12
+
+// Byte offsets in the journal
+#define JOURNAL_MAGIC_OFFSET   0
+#define JOURNAL_BASE_OFFSET    4 // Sequence number of the slot the records apply to
+#define JOURNAL_RECORDS_OFFSET 8
+
+// Record types, anything else ends the journal
+#define RECORD_DELTA  0xD1 // u16 offset in the image, u8 length, the bytes
+#define RECORD_COMMIT 0xC0 // u32 checksum of the image with the deltas before it applied
+#define RECORD_END    0xFF // The same as blank SRAM
+
+#define DELTA_HEADER_SIZE 4
+#define DELTA_MAX_LEN     255
+#define COMMIT_SIZE       5
+// Unchanged runs shorter than a record header are rewritten rather than starting a new record
+#define DELTA_MERGE_GAP   DELTA_HEADER_SIZE
+
+typedef struct
+{
+    u16 sram_offset;
+    u16 staging_offset;
+    u16 len;
+} SaveWrite;
+
+#define MAX_WRITES 3 // A full image: the image, its header and the journal header
+
+static bool enabled = false;
+static u16 image_version = 0;
+static int image_size = 0;
+
+static bool exists = false;
+static int base_slot = UNDEFINED;   // Slot the journal applies to
+static u32 base_sequence = 0;
+static int journal_end = UNDEFINED; // Where the next records go, UNDEFINED if the next save has to be a full image
+
+static EWRAM_BSS u8 committed[SAVE_MAX_SIZE]; // The save as it will be in SRAM once the queued writes are done
+static EWRAM_BSS u8 staging[SAVE_SLOT_SIZE + JOURNAL_RECORDS_OFFSET + 1]; // The bytes of the queued writes
+
+static SaveWrite writes[MAX_WRITES];
+static int num_writes = 0;
+static int next_write = 0;
+static int next_write_done = 0; // Bytes of the next write already in SRAM
+
+static SaveStats stats = {0};
+
+// FNV-1a
+static u32 save_checksum(const u8 *data, int size)
+{
+    u32 hash = 2166136261u;
+    for (int i = 0; i < size; i++)
+    {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static u32 sram_read(int offset, int size)
+{
+    u32 value = 0;
+    for (int i = 0; i < size; i++)
+    {
+        value |= (u32)SAVE_SRAM[offset + i] << (i * 8);
+    }
+    return value;
+}
+
+static void sram_read_bytes(u8 *dst, int offset, int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        dst[i] = SAVE_SRAM[offset + i];
+    }
+}
+
+static void staging_put(int offset, int size, u32 value)
+{
+    for (int i = 0; i < size; i++)
+    {
+        staging[offset + i] = value >> (i * 8);
+    }
+}
+
+static void save_queue_write(int sram_offset, int staging_offset, int len)
+{
+    writes[num_writes++] = (SaveWrite){sram_offset, staging_offset, len};
+}
+
+// Writes everything queued right away, so staging can be reused
+static void save_finish_writes(void)
+{
+    while (num_writes > 0)
+    {
+        save_update();
+    }
+}
+
+static bool save_slot_read(int slot)
+{
+    int base = slot * SAVE_SLOT_SIZE;
+    if (sram_read(base + SLOT_MAGIC_OFFSET, 4) != SLOT_MAGIC
+        || sram_read(base + SLOT_VERSION_OFFSET, 2) != image_version
+        || sram_read(base + SLOT_SIZE_OFFSET, 2) != image_size)
+    {
+        return false;
+    }
+
+    u32 sequence = sram_read(base + SLOT_SEQUENCE_OFFSET, 4);
+    if (base_slot != UNDEFINED && sequence <= base_sequence)
+    {
+        return false;
+    }
+
+    sram_read_bytes(staging, base + SAVE_HEADER_SIZE, image_size);
+    if (save_checksum(staging, image_size) != sram_read(base + SLOT_CHECKSUM_OFFSET, 4))
+    {
+        return false;
+    }
+
+    memcpy(committed, staging, image_size);
+    base_slot = slot;
+    base_sequence = sequence;
+    return true;
+}
+
+// Applies the journal records up to the last valid commit
+static void save_journal_read(void)
+{
+    if (sram_read(JOURNAL_OFFSET + JOURNAL_MAGIC_OFFSET, 4) != JOURNAL_MAGIC
+        || sram_read(JOURNAL_OFFSET + JOURNAL_BASE_OFFSET, 4) != base_sequence)
+    {
+        return;
+    }
+
+    memcpy(staging, committed, image_size);
+    int pos = JOURNAL_RECORDS_OFFSET;
+    journal_end = pos;
+
+    while (pos < JOURNAL_SIZE)
+    {
+        int type = SAVE_SRAM[JOURNAL_OFFSET + pos];
+        if (type == RECORD_DELTA && pos + DELTA_HEADER_SIZE <= JOURNAL_SIZE)
+        {
+            int offset = sram_read(JOURNAL_OFFSET + pos + 1, 2);
+            int len = sram_read(JOURNAL_OFFSET + pos + 3, 1);
+            if (len == 0 || offset + len > image_size || pos + DELTA_HEADER_SIZE + len > JOURNAL_SIZE)
+                break;
+
+            sram_read_bytes(&staging[offset], JOURNAL_OFFSET + pos + DELTA_HEADER_SIZE, len);
+            pos += DELTA_HEADER_SIZE + len;
+        }
+        else if (type == RECORD_COMMIT && pos + COMMIT_SIZE <= JOURNAL_SIZE)
+        {
+            if (save_checksum(staging, image_size) != sram_read(JOURNAL_OFFSET + pos + 1, 4))
+                break;
+
+            pos += COMMIT_SIZE;
+            memcpy(committed, staging, image_size);
+            journal_end = pos;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+void save_init(u16 version, int size)
+{
+#if defined(INPUT_RECORD) || defined(INPUT_REPLAY)
+    return;
+#endif
+
+    // Starts over if called again, the queued writes are lost as if the power had been turned off
+    enabled = false;
+    exists = false;
+    base_slot = UNDEFINED;
+    base_sequence = 0;
+    journal_end = UNDEFINED;
+    num_writes = 0;
+    next_write = 0;
+    next_write_done = 0;
+
+    if (size > SAVE_MAX_SIZE)
+        return;
+
+    enabled = true;
+    image_version = version;
+    image_size = size;
+
+    for (int slot = 0; slot < NUM_SLOTS; slot++)
+    {
+        save_slot_read(slot);
+    }
+
+    if (base_slot == UNDEFINED)
+        return;
+
+    exists = true;
+    save_journal_read();
+}
+
+bool save_exists(void)
+{
+    return exists;
+}
+
+bool save_load(void *image)
+{
+    if (!exists)
+        return false;
+
+    memcpy(image, committed, image_size);
+    return true;
+}
+
+/* Puts the records for the bytes of image that differ from the save into staging.
+ * Returns their size, 0 if nothing changed or UNDEFINED if they don't fit in the journal
+ * or wouldn't be much smaller than the full image.
+ */
+static int save_journal_build(const u8 *image)
+{
+    int limit = min(JOURNAL_SIZE - journal_end, image_size / 2 + COMMIT_SIZE + 1);
+    int pos = 0;
+
+    for (int i = 0; i < image_size; )
+    {
+        if (image[i] == committed[i])
+        {
+            i++;
+            continue;
+        }
+
+        int start = i;
+        int end = i + 1;
+        for (int j = i + 1; j < image_size && j - start < DELTA_MAX_LEN && j - end < DELTA_MERGE_GAP; j++)
+        {
+            if (image[j] != committed[j])
+            {
+                end = j + 1;
+            }
+        }
+
+        int len = end - start;
+        if (pos + DELTA_HEADER_SIZE + len + COMMIT_SIZE + 1 > limit)
+            return UNDEFINED;
+
+        staging[pos] = RECORD_DELTA;
+        staging_put(pos + 1, 2, start);
+        staging_put(pos + 3, 1, len);
+        memcpy(&staging[pos + DELTA_HEADER_SIZE], &image[start], len);
+        pos += DELTA_HEADER_SIZE + len;
+        i = end;
+    }
+
+    if (pos == 0)
+        return 0;
+
+    staging[pos] = RECORD_COMMIT;
+    staging_put(pos + 1, 4, save_checksum(image, image_size));
+    pos += COMMIT_SIZE;
+    staging[pos++] = RECORD_END;
+    return pos;
+}
+
+// Writes all of image to the slot the journal isn't for and starts a new journal for it
+static void save_snapshot_build(const u8 *image)
+{
+    int slot = base_slot == 0 ? 1 : 0;
+    u32 sequence = base_sequence + 1;
+
+    int header = image_size;
+    int journal_header = header + SAVE_HEADER_SIZE;
+
+    memcpy(staging, image, image_size);
+    staging_put(header + SLOT_CHECKSUM_OFFSET, 4, save_checksum(image, image_size));
+    staging_put(header + SLOT_VERSION_OFFSET, 2, image_version);
+    staging_put(header + SLOT_SIZE_OFFSET, 2, image_size);
+    staging_put(header + SLOT_SEQUENCE_OFFSET, 4, sequence);
+    staging_put(header + SLOT_MAGIC_OFFSET, 4, SLOT_MAGIC);
+    staging_put(journal_header + JOURNAL_MAGIC_OFFSET, 4, JOURNAL_MAGIC);
+    staging_put(journal_header + JOURNAL_BASE_OFFSET, 4, sequence);
+    staging[journal_header + JOURNAL_RECORDS_OFFSET] = RECORD_END;
+
+    save_queue_write(slot * SAVE_SLOT_SIZE + SAVE_HEADER_SIZE, 0, image_size);
+    save_queue_write(slot * SAVE_SLOT_SIZE, header, SAVE_HEADER_SIZE);
+    save_queue_write(JOURNAL_OFFSET, journal_header, JOURNAL_RECORDS_OFFSET + 1);
+
+    base_slot = slot;
+    base_sequence = sequence;
+    journal_end = JOURNAL_RECORDS_OFFSET;
+}
+
+void save_write(const void *image)
+{
+    if (!enabled)
+        return;
+
+    save_finish_writes();
+
+    if (exists && journal_end != UNDEFINED)
+    {
+        int len = save_journal_build(image);
+        if (len == 0)
+        {
+            stats.skipped_writes++;
+            return;
+        }
+
+        if (len != UNDEFINED)
+        {
+            save_queue_write(JOURNAL_OFFSET + journal_end, 0, len);
+            journal_end += len - 1; // The next records go over the end marker
+            memcpy(committed, image, image_size);
+            stats.journal_writes++;
+            return;
+        }
+    }
+
+    save_snapshot_build(image);
+    memcpy(committed, image, image_size);
+    exists = true;
+    stats.snapshot_writes++;
+}
+
+void save_erase(void)
+{
+    if (!enabled || !exists)
+        return;
+
+    save_finish_writes();
+
+    staging_put(0, 4, 0);
+    for (int slot = 0; slot < NUM_SLOTS; slot++)
+    {
+        save_queue_write(slot * SAVE_SLOT_SIZE + SLOT_MAGIC_OFFSET, 0, 4);
+    }
+
+    exists = false;
+    base_slot = UNDEFINED;
+    journal_end = UNDEFINED;
+}
+
+void save_update(void)
+{
+    int budget = SAVE_BYTES_PER_FRAME;
+    while (budget > 0 && next_write < num_writes)
+    {
+        const SaveWrite *write = &writes[next_write];
+        int len = min(budget, write->len - next_write_done);
+        for (int i = 0; i < len; i++)
+        {
+            SAVE_SRAM[write->sram_offset + next_write_done + i] = staging[write->staging_offset + next_write_done + i];
+        }
+
+        next_write_done += len;
+        budget -= len;
+        stats.bytes_written += len;
+        if (next_write_done == write->len)
+        {
+            next_write++;
+            next_write_done = 0;
+        }
+    }
+
+    if (next_write == num_writes)
+    {
+        num_writes = 0;
+        next_write = 0;
+    }
+}
+
+const SaveStats *save_get_stats(void)
+{
+    return &stats;
+}
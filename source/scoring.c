@@ -0,0 +1,75 @@
+#include "scoring.h"
+#include "util.h"
+
+static inline void score_result_add_event(ScoreResult *result, enum ScoringEventType type, int card_idx, int joker_idx, const JokerEffect *effect)
+{
+    if (result->num_events >= MAX_SCORING_EVENTS)
+        return;
+
+    ScoringEvent *event = &result->events[result->num_events++];
+    event->type = type;
+    event->card_idx = card_idx;
+    event->joker_idx = joker_idx;
+    event->effect = *effect;
+    event->chips = result->chips;
+    event->mult = result->mult;
+}
+
+// Compares the fields, memcmp() would also compare the padding which isn't zeroed when returning by value
+static inline bool joker_effect_is_empty(const JokerEffect *effect)
+{
+    return effect->chips == 0 && effect->mult == 0 && effect->xmult == 0 && effect->money == 0 && !effect->retrigger;
+}
+
+// Applies and records the joker's effect if it triggers
+static inline void score_joker(ScoreResult *result, const JokerDispatchEntry *entry, Card *scored_card, int card_idx, HandContext *hand_context)
+{
+    JokerEffect effect = entry->fixed_effect != NULL ? *entry->fixed_effect : entry->effect(entry->joker, scored_card, hand_context);
+
+    if (joker_effect_is_empty(&effect))
+        return;
+
+    result->chips += effect.chips;
+    result->mult += effect.mult;
+    result->mult *= effect.xmult > 0 ? effect.xmult : 1; // if xmult is zero, DO NOT multiply by it
+    result->money += effect.money;
+    hand_context->money_earned = result->money; // So the jokers after this one see it
+    // TODO: Retrigger
+
+    score_result_add_event(result, SCORING_EVENT_JOKER, card_idx, entry->joker_idx, &effect);
+}
+
+ARM_IWRAM_CODE void score_hand(Card *scoring_cards[], int num_scoring_cards, HandContext *hand_context,
+                const JokerDispatch *jokers, int base_chips, int base_mult, ScoreResult *result_out)
+{
+    result_out->chips = base_chips;
+    result_out->mult = base_mult;
+    result_out->money = 0;
+    result_out->num_events = 0;
+    hand_context->money_earned = 0;
+
+    const JokerDispatchEntry *on_scored = jokers->entries[JOKER_PHASE_ON_SCORED];
+    int num_on_scored = jokers->num_entries[JOKER_PHASE_ON_SCORED];
+
+    // Each scoring card adds its value, then the jokers that trigger on it do in order
+    for (int i = 0; i < num_scoring_cards; i++)
+    {
+        JokerEffect card_effect = {0};
+        card_effect.chips = card_get_value(scoring_cards[i]);
+        result_out->chips += card_effect.chips;
+        score_result_add_event(result_out, SCORING_EVENT_CARD, i, UNDEFINED, &card_effect);
+
+        for (int j = 0; j < num_on_scored; j++)
+        {
+            score_joker(result_out, &on_scored[j], scoring_cards[i], i, hand_context);
+        }
+    }
+
+    // Then the independent jokers that apply to the whole hand, held in hand jokers included
+    const JokerDispatchEntry *independent = jokers->entries[JOKER_PHASE_INDEPENDENT];
+    int num_independent = jokers->num_entries[JOKER_PHASE_INDEPENDENT];
+    for (int j = 0; j < num_independent; j++)
+    {
+        score_joker(result_out, &independent[j], NULL, UNDEFINED, hand_context);
+    }
+}
@@ -0,0 +1,181 @@
+#include "solver.h"
+#include "hand_analysis.h"
+#include "rng.h"
+#include "util.h"
+
+// Next higher number with the same number of set bits (Gosper's hack), without the division
+static u32 next_combination(u32 mask)
+{
+    u32 lowest = mask & -mask;
+    u32 ripple = mask + lowest;
+    return (((ripple ^ mask) >> 2) >> __builtin_ctz(lowest)) | ripple;
+}
+
+void solver_start(Solver *solver, Card *hand[], int hand_size, const JokerDispatch *jokers)
+{
+    solver->hand_size = hand_size;
+    solver->face_mask = 0;
+    for (int i = 0; i < hand_size; i++)
+    {
+        solver->hand[i] = hand[i];
+        if (card_is_face(hand[i]))
+        {
+            solver->face_mask |= 1u << i;
+        }
+    }
+
+    solver->jokers = *jokers;
+    solver->needs_held_cards = jokers->num_entries[JOKER_PHASE_HELD] > 0;
+
+    solver->next_mask = 1;
+    solver->num_evaluated = 0;
+    solver->done = hand_size == 0;
+    solver->best_mask = 0;
+    solver->best_hand_type = NONE;
+    solver->best_score = UNDEFINED;
+
+    solver->played_mask = 0;
+    hand_distribution_clear(&solver->distribution);
+    hand_context_make(&solver->hand_context, NONE, 0, NULL, 0, NULL, 0);
+
+    // These don't read the context, so the empty one will do
+    JokerDispatchEntry *independent = solver->jokers.entries[JOKER_PHASE_INDEPENDENT];
+    for (int i = 0; i < solver->jokers.num_entries[JOKER_PHASE_INDEPENDENT]; i++)
+    {
+        if (get_joker_registry_entry(independent[i].joker->id)->phases & JOKER_PLAY_INVARIANT)
+        {
+            solver->fixed_effects[i] = independent[i].effect(independent[i].joker, NULL, &solver->hand_context);
+            independent[i].fixed_effect = &solver->fixed_effects[i];
+        }
+    }
+}
+
+// Brings the distribution from the previous play to this one, combinations of the same size differ by few cards
+static void solver_set_played_mask(Solver *solver, u32 mask)
+{
+    for (u32 removed = solver->played_mask & ~mask; removed != 0; removed &= removed - 1)
+    {
+        hand_distribution_remove_card(&solver->distribution, solver->hand[__builtin_ctz(removed)]);
+    }
+    for (u32 added = mask & ~solver->played_mask; added != 0; added &= added - 1)
+    {
+        hand_distribution_add_card(&solver->distribution, solver->hand[__builtin_ctz(added)]);
+    }
+    solver->played_mask = mask;
+}
+
+static int solver_score_play(Solver *solver, u32 mask, enum HandType *hand_type_out)
+{
+    solver_set_played_mask(solver, mask);
+    enum HandType hand_type = hand_distribution_get_type(&solver->distribution);
+
+    // Cards are played from the end of the hand first, see cards_in_hand_update_loop()
+    Card *played_cards[MAX_SELECTION_SIZE];
+    u8 played_idx[MAX_SELECTION_SIZE];
+    int num_played_cards = 0;
+    for (u32 rest = mask; rest != 0; )
+    {
+        int i = 31 - __builtin_clz(rest);
+        rest &= ~(1u << i);
+        played_idx[num_played_cards] = i;
+        played_cards[num_played_cards++] = solver->hand[i];
+    }
+
+    bool is_scoring[MAX_SELECTION_SIZE];
+    hand_get_scoring_cards(played_cards, num_played_cards, hand_type, is_scoring);
+
+    Card *scoring_cards[MAX_SELECTION_SIZE];
+    int num_scoring_cards = 0;
+    u32 scoring_mask = 0;
+    for (int i = 0; i < num_played_cards; i++)
+    {
+        if (is_scoring[i])
+        {
+            scoring_cards[num_scoring_cards++] = played_cards[i];
+            scoring_mask |= 1u << played_idx[i];
+        }
+    }
+
+    // Same as hand_context_make(), but the distribution is only rebuilt when some played cards don't score
+    HandContext *hand_context = &solver->hand_context;
+    hand_context->hand_type = hand_type;
+    hand_context->played_count = num_played_cards;
+    hand_context->scoring_count = num_scoring_cards;
+    hand_context->face_count = __builtin_popcount(scoring_mask & solver->face_mask);
+
+    if (num_scoring_cards == num_played_cards)
+    {
+        hand_context->distribution = solver->distribution;
+    }
+    else
+    {
+        hand_distribution_clear(&hand_context->distribution);
+        for (int i = 0; i < num_scoring_cards; i++)
+        {
+            hand_distribution_add_card(&hand_context->distribution, scoring_cards[i]);
+        }
+    }
+
+    // Left empty when no joker reads them
+    hand_context->held_count = 0;
+    if (solver->needs_held_cards)
+    {
+        for (int i = 0; i < solver->hand_size; i++)
+        {
+            if (!((mask >> i) & 1))
+            {
+                hand_context->held_cards[hand_context->held_count++] = solver->hand[i];
+            }
+        }
+    }
+
+    // Jokers that roll must not consume the real stream, and every play should see the same rolls
+    const HandTypeInfo *info = hand_type_get_info(hand_type);
+    u32 joker_rng_state = rng_get_state(RNG_JOKER);
+    score_hand(scoring_cards, num_scoring_cards, hand_context, &solver->jokers,
+               info->base_chips, info->base_mult, &solver->score_result);
+    rng_set_state(RNG_JOKER, joker_rng_state);
+
+    *hand_type_out = hand_type;
+    return solver->score_result.chips * solver->score_result.mult;
+}
+
+bool solver_step(Solver *solver)
+{
+    if (solver->done)
+        return false;
+
+    u32 mask = solver->next_mask;
+    enum HandType hand_type;
+    int score = solver_score_play(solver, mask, &hand_type);
+    solver->num_evaluated++;
+
+    // Plays are evaluated from the fewest cards up so ties keep the smaller play
+    if (score > solver->best_score)
+    {
+        solver->best_score = score;
+        solver->best_mask = mask;
+        solver->best_hand_type = hand_type;
+    }
+
+    // Move on to the next combination of the same size, or to the first one of the next size
+    u32 next_mask = next_combination(mask);
+    if (next_mask >= (1u << solver->hand_size))
+    {
+        int next_size = __builtin_popcount(mask) + 1;
+        if (next_size > MAX_SELECTION_SIZE || next_size > solver->hand_size)
+        {
+            solver->done = true;
+            return false;
+        }
+        next_mask = (1u << next_size) - 1;
+    }
+
+    solver->next_mask = next_mask;
+    return true;
+}
+
+void solver_solve(Solver *solver)
+{
+    while (solver_step(solver));
+}
@@ -3,39 +3,70 @@
 #include "util.h"
 #include "audio_utils.h"
 #include "soundbank.h"
+#include "rng.h"
+#include "pool.h"
+#include "tile_cache.h"
+#include "pal_bank.h"
+#include "vram_queue.h"
 
 #include <tonc.h>
-#include <stdlib.h>
 #include <maxmod.h>
 
 #define MAX_SPRITES 128
 #define MAX_AFFINES 32
 #define SPRITE_FOCUS_RAISE_PX 10
+#define OAM_MAX_COPY_GAP 4 // Unchanged OAM entries between changed ones are copied along instead of starting another copy
+#define SPRITE_DAMPING_NUM 1434 // 0.7 * 2^SPRITE_DAMPING_SHIFT
+#define SPRITE_DAMPING_SHIFT 11
 
 OBJ_ATTR obj_buffer[MAX_SPRITES];
 OBJ_AFFINE *obj_aff_buffer = (OBJ_AFFINE*)obj_buffer;
 
-static Sprite *free_sprites[MAX_SPRITES] = {NULL};
+// A sprite is tied to its OAM entry, so each entry has its own Sprite instead of a pool slot
+static Sprite sprites[MAX_SPRITES];
+static bool used_sprites[MAX_SPRITES] = {false};
 static bool free_affines[MAX_AFFINES] = {false};
 
+// OAM entry i shows obj_buffer[oam_order[i]]. Entries with lower indices are drawn on top,
+// so this sets the depth of the sprites without moving them or their tiles to other layers.
+static u8 oam_order[MAX_SPRITES];
+static u8 oam_entries[MAX_SPRITES]; // The OAM entry of each layer, the inverse of oam_order
+
+// What OAM holds once the VRAM queue has been flushed, entries are only copied to OAM when they change here
+static OBJ_ATTR oam_shadow[MAX_SPRITES];
+
+// Set by sprite_mark_dirty(), sprite_draw() only looks at these layers and affine matrices
+static u32 dirty_layers[MAX_SPRITES / 32];
+static u32 dirty_affines; // One bit per affine matrix, MAX_AFFINES is 32
+
+POOL_DEFINE(SpriteObject, sprite_object_pool, MAX_SPRITE_OBJECTS);
+
+const Pool *sprite_object_get_pool(void)
+{
+    return &sprite_object_pool;
+}
+
 // Sprite methods
 Sprite *sprite_new(u16 a0, u16 a1, u32 tid, u32 pb, int sprite_index)
 {
-    Sprite *sprite = malloc(sizeof(Sprite));
-
-    sprite->obj = NULL;
-    sprite->aff = NULL;
-
-    if(!free_sprites[sprite_index])
+    if (tid == (u32)UNDEFINED || pb == (u32)UNDEFINED)
     {
-        free_sprites[sprite_index] = sprite;
+        tile_cache_release(tid);
+        pal_bank_release(pb);
+        return NULL;
     }
-    else
+
+    if (used_sprites[sprite_index])
     {
-        free(sprite);
+        tile_cache_release(tid);
+        pal_bank_release(pb);
         return NULL;
     }
 
+    Sprite *sprite = &sprites[sprite_index];
+    sprite->obj = NULL;
+    sprite->aff = NULL;
+
     if (a0 & ATTR0_AFF)
     {
         int aff_index = MAX_AFFINES;
@@ -52,22 +83,27 @@ Sprite *sprite_new(u16 a0, u16 a1, u32 tid, u32 pb, int sprite_index)
 
         if (aff_index == MAX_AFFINES)
         {
-            free(sprite);
+            tile_cache_release(tid);
+            pal_bank_release(pb);
             return NULL;
         }
 
+        used_sprites[sprite_index] = true;
         a1 = a1 | ATTR1_AFF_ID(aff_index);
 
         sprite->obj = &obj_buffer[sprite_index];
         sprite->aff = &obj_aff_buffer[aff_index];
         obj_set_attr(sprite->obj, a0, a1, ATTR2_PALBANK(pb) | tid);
         obj_aff_identity(&obj_aff_buffer[aff_index]);
+        sprite_mark_dirty(sprite);
         return sprite;
     }
     else
     {
+        used_sprites[sprite_index] = true;
         sprite->obj = &obj_buffer[sprite_index];
         obj_set_attr(sprite->obj, a0, a1, ATTR2_PALBANK(pb) | tid);
+        sprite_mark_dirty(sprite);
         return sprite;
     }
 }
@@ -75,13 +111,14 @@ Sprite *sprite_new(u16 a0, u16 a1, u32 tid, u32 pb, int sprite_index)
 void sprite_destroy(Sprite **sprite)
 {
     if (*sprite == NULL) return;
-    obj_hide((*sprite)->obj);
-    free_sprites[(*sprite)->obj - obj_buffer] = NULL;
+    sprite_hide(*sprite);
+    tile_cache_release((*sprite)->obj->attr2 & ATTR2_ID_MASK); // Every sprite's tiles come from the tile cache
+    pal_bank_release(sprite_get_pb(*sprite)); // And its palette bank from the palette bank allocator
+    used_sprites[(*sprite)->obj - obj_buffer] = false;
     if ((*sprite)->aff != NULL)
     {
         free_affines[(*sprite)->aff - obj_aff_buffer] = false;
     }
-    free(*sprite);
     *sprite = NULL;
 }
 
@@ -91,16 +128,151 @@ int sprite_get_layer(Sprite *sprite)
     return sprite->obj - obj_buffer;
 }
 
+static inline void sprite_mark_layer_dirty(int layer)
+{
+    dirty_layers[layer / 32] |= 1u << (layer % 32);
+}
+
+void sprite_mark_dirty(const Sprite *sprite)
+{
+    sprite_mark_layer_dirty(sprite->obj - obj_buffer);
+    if (sprite->aff != NULL)
+    {
+        dirty_affines |= 1u << (sprite->aff - obj_aff_buffer);
+    }
+}
+
 // Sprite functions
 void sprite_init()
 {
     oam_init(obj_buffer, MAX_SPRITES); 
+    tile_cache_init();
+    pal_bank_init();
+
+    for (int i = 0; i < MAX_SPRITES; i++)
+    {
+        oam_order[i] = i;
+        oam_entries[i] = i;
+        oam_shadow[i] = obj_buffer[i]; // oam_init() has already copied them to OAM
+    }
+}
+
+static inline void oam_entry_mark_changed(u32 changed[], int entry)
+{
+    changed[entry / 32] |= 1u << (entry % 32);
+}
+
+static inline bool oam_entry_is_changed(const u32 changed[], int entry)
+{
+    return (changed[entry / 32] >> (entry % 32)) & 1;
 }
 
 void sprite_draw()
 {
-    obj_aff_copy(obj_aff_mem, obj_aff_buffer, MAX_AFFINES);
-    oam_copy(oam_mem, obj_buffer, MAX_SPRITES);
+    u32 changed[MAX_SPRITES / 32] = {0};
+
+    for (int i = 0; i < MAX_SPRITES / 32; i++)
+    {
+        u32 bits = dirty_layers[i];
+        dirty_layers[i] = 0;
+
+        while (bits != 0)
+        {
+            int layer = i * 32 + __builtin_ctz(bits);
+            bits &= bits - 1;
+
+            int entry = oam_entries[layer];
+            const OBJ_ATTR *obj = &obj_buffer[layer];
+            OBJ_ATTR *shadow = &oam_shadow[entry];
+            if (shadow->attr0 != obj->attr0 || shadow->attr1 != obj->attr1 || shadow->attr2 != obj->attr2)
+            {
+                // Not the fill, that's where the affine matrices go
+                obj_set_attr(shadow, obj->attr0, obj->attr1, obj->attr2);
+                oam_entry_mark_changed(changed, entry);
+            }
+        }
+    }
+
+    // The affine matrices are spread over the fill of 4 entries each, whatever entries are ordered there
+    OBJ_AFFINE *shadow_affs = (OBJ_AFFINE*)oam_shadow;
+    u32 bits = dirty_affines;
+    dirty_affines = 0;
+    while (bits != 0)
+    {
+        int aff_index = __builtin_ctz(bits);
+        bits &= bits - 1;
+
+        const OBJ_AFFINE *aff = &obj_aff_buffer[aff_index];
+        OBJ_AFFINE *shadow = &shadow_affs[aff_index];
+        if (shadow->pa != aff->pa || shadow->pb != aff->pb || shadow->pc != aff->pc || shadow->pd != aff->pd)
+        {
+            obj_aff_copy(shadow, aff, 1);
+            for (int entry = aff_index * 4; entry < aff_index * 4 + 4; entry++)
+            {
+                oam_entry_mark_changed(changed, entry);
+            }
+        }
+    }
+
+    // Copy runs of changed entries, a frame where nothing changed copies nothing
+    int entry = 0;
+    while (entry < MAX_SPRITES)
+    {
+        if (!oam_entry_is_changed(changed, entry))
+        {
+            entry++;
+            continue;
+        }
+
+        int first = entry;
+        int last = entry;
+        for (entry++; entry < MAX_SPRITES && entry - last <= OAM_MAX_COPY_GAP + 1; entry++)
+        {
+            if (oam_entry_is_changed(changed, entry))
+            {
+                last = entry;
+            }
+        }
+
+        vram_queue_copy32(&oam_mem[first], &oam_shadow[first], (last - first + 1) * sizeof(OBJ_ATTR) / 4);
+        entry = last + 1;
+    }
+}
+
+// Shows layer at an OAM entry, sprite_draw() copies it there if it isn't already
+static inline void sprite_range_set_entry(int entry, int layer)
+{
+    if (oam_order[entry] == layer)
+        return;
+
+    oam_order[entry] = layer;
+    oam_entries[layer] = entry;
+    sprite_mark_layer_dirty(layer);
+}
+
+void sprite_range_set_order(int first_layer, int num_layers, Sprite *sprites[], int num_sprites)
+{
+    bool ordered[MAX_SPRITES] = {false};
+    int entry = first_layer;
+
+    for (int i = 0; i < num_sprites; i++)
+    {
+        int layer = sprite_get_layer(sprites[i]);
+        if (layer < first_layer || layer >= first_layer + num_layers || ordered[layer])
+            continue;
+
+        sprite_range_set_entry(entry++, layer);
+        ordered[layer] = true;
+    }
+
+    // The layers that weren't listed go behind, so every layer still has exactly one entry
+    for (int layer = first_layer; layer < first_layer + num_layers; layer++)
+    {
+        if (!ordered[layer])
+        {
+            sprite_range_set_entry(entry++, layer);
+        }
+    }
 }
 
 int sprite_get_pb(const Sprite *sprite)
@@ -115,7 +287,8 @@ int sprite_get_pb(const Sprite *sprite)
 // SpriteObject methods
 SpriteObject* sprite_object_new()
 {
-    SpriteObject* sprite_object = (SpriteObject*)malloc(sizeof(SpriteObject));
+    SpriteObject* sprite_object = sprite_object_pool_alloc();
+    if (sprite_object == NULL) return NULL;
     sprite_object->sprite = NULL;
     sprite_object_reset_transform(sprite_object);
     sprite_object->selected = false;
@@ -128,7 +301,7 @@ void sprite_object_destroy(SpriteObject** sprite_object)
 {
     if (*sprite_object == NULL) return;
     sprite_destroy(&((*sprite_object)->sprite));
-    free(*sprite_object);
+    sprite_object_pool_free(*sprite_object);
     *sprite_object = NULL;
 }
 
@@ -138,6 +311,7 @@ void sprite_object_set_sprite(SpriteObject* sprite_object, Sprite* sprite)
         return;
     sprite_destroy(&sprite_object->sprite); // Destroy the old sprite if it exists
     sprite_object->sprite = sprite;
+    sprite_object->asleep = false; // The new sprite still has to be placed
 }
 
 void sprite_object_reset_transform(SpriteObject* sprite_object)
@@ -154,12 +328,21 @@ void sprite_object_reset_transform(SpriteObject* sprite_object)
     sprite_object->trotation = 0; // Target rotation
     sprite_object->rotation = 0;
     sprite_object->vrotation = 0;
+    sprite_object->asleep = false;
 }
 
-void sprite_object_update(SpriteObject* sprite_object)
+// Velocity * 0.7, rounded towards zero the same for both signs
+static inline FIXED sprite_object_damp(FIXED v)
+{
+    return v >= 0 ? (v * SPRITE_DAMPING_NUM) >> SPRITE_DAMPING_SHIFT : -((-v * SPRITE_DAMPING_NUM) >> SPRITE_DAMPING_SHIFT);
+}
+
+// Pulls the position, scale and rotation towards their targets, returns whether they have all settled
+ARM_IWRAM_CODE static bool sprite_object_integrate(SpriteObject *sprite_object, int speed)
 {
-    sprite_object->vx += ((sprite_object->tx - sprite_object->x) * get_game_speed()) / 8;
-    sprite_object->vy += ((sprite_object->ty - sprite_object->y) * get_game_speed()) / 8;
+    // Divisions by 8 compile to shifts, only the damping needed a call to the software divide
+    sprite_object->vx += ((sprite_object->tx - sprite_object->x) * speed) / 8;
+    sprite_object->vy += ((sprite_object->ty - sprite_object->y) * speed) / 8;
 
     sprite_object->vscale += (sprite_object->tscale - sprite_object->scale) / 8; // Scale up the card when it's played
 
@@ -167,6 +350,7 @@ void sprite_object_update(SpriteObject* sprite_object)
 
     // set velocity to 0 if it's close enough to the target
     const FIXED epsilon = float2fx(0.01f);
+    bool settled = true;
     if (sprite_object->vx < epsilon && sprite_object->vx > -epsilon && sprite_object->vy < epsilon && sprite_object->vy > -epsilon)
     {
         sprite_object->vx = 0;
@@ -177,11 +361,12 @@ void sprite_object_update(SpriteObject* sprite_object)
     }
     else
     {
-        sprite_object->vx = (sprite_object->vx * 7) / 10;
-        sprite_object->vy = (sprite_object->vy * 7) / 10;
+        sprite_object->vx = sprite_object_damp(sprite_object->vx);
+        sprite_object->vy = sprite_object_damp(sprite_object->vy);
 
         sprite_object->x += sprite_object->vx;
         sprite_object->y += sprite_object->vy;
+        settled = false;
     }
 
     // Set scale to 0 if it's close enough to the target
@@ -192,8 +377,9 @@ void sprite_object_update(SpriteObject* sprite_object)
     }
     else
     {
-        sprite_object->vscale = (sprite_object->vscale * 7) / 10;
+        sprite_object->vscale = sprite_object_damp(sprite_object->vscale);
         sprite_object->scale += sprite_object->vscale;
+        settled = false;
     }
 
     // Set rotation to 0 if it's close enough to the target
@@ -204,16 +390,50 @@ void sprite_object_update(SpriteObject* sprite_object)
     }
     else
     {
-        sprite_object->vrotation = (sprite_object->vrotation * 7) / 10;
+        sprite_object->vrotation = sprite_object_damp(sprite_object->vrotation);
         sprite_object->rotation += sprite_object->vrotation;
+        settled = false;
+    }
+
+    return settled;
+}
+
+static bool sprite_object_can_sleep(const SpriteObject *sprite_object)
+{
+    // Targets and positions are written directly by the game, so check that nothing moved since it settled
+    return sprite_object->asleep
+        && sprite_object->x == sprite_object->rest_x && sprite_object->y == sprite_object->rest_y
+        && sprite_object->scale == sprite_object->rest_scale && sprite_object->rotation == sprite_object->rest_rotation
+        && sprite_object->tx == sprite_object->x && sprite_object->ty == sprite_object->y
+        && sprite_object->tscale == sprite_object->scale && sprite_object->trotation == sprite_object->rotation
+        && (sprite_object->vx | sprite_object->vy | sprite_object->vscale | sprite_object->vrotation) == 0;
+}
+
+void sprite_object_update(SpriteObject* sprite_object)
+{
+    if (sprite_object_can_sleep(sprite_object))
+        return;
+
+    bool settled = sprite_object_integrate(sprite_object, get_game_speed());
+
+    // Without a sprite, when there was no palette bank or tiles for it, the object still moves but isn't shown
+    if (sprite_object->sprite != NULL)
+    {
+        obj_aff_rotscale(sprite_object->sprite->aff, sprite_object->scale, sprite_object->scale, -sprite_object->vx + sprite_object->rotation); // Apply rotation and scale to the sprite
+        sprite_position(sprite_object->sprite, fx2int(sprite_object->x), fx2int(sprite_object->y));
     }
 
-    obj_aff_rotscale(sprite_object->sprite->aff, sprite_object->scale, sprite_object->scale, -sprite_object->vx + sprite_object->rotation); // Apply rotation and scale to the sprite
-    sprite_position(sprite_object->sprite, fx2int(sprite_object->x), fx2int(sprite_object->y));
+    // Sleep once a frame has been drawn at rest
+    sprite_object->asleep = settled;
+    sprite_object->rest_x = sprite_object->x;
+    sprite_object->rest_y = sprite_object->y;
+    sprite_object->rest_scale = sprite_object->scale;
+    sprite_object->rest_rotation = sprite_object->rotation;
 }
 
 void sprite_object_shake(SpriteObject* sprite_object, mm_word sound_id)
 {
+    sprite_object->asleep = false;
     sprite_object->vscale = float2fx(0.3f);
     sprite_object->vrotation = float2fx(8.0f); //Rotate the card when it's scored
 
@@ -251,7 +471,7 @@ void sprite_object_set_focus(SpriteObject* sprite_object, bool focus)
     }
     sprite_object->focused = focus;
 
-    play_sfx(SFX_CARD_FOCUS , MM_BASE_PITCH_RATE + rand() % 512);
+    play_sfx(SFX_CARD_FOCUS , MM_BASE_PITCH_RATE + rng_range(RNG_COSMETIC, 512));
     sprite_object->ty = sprite_object->ty + int2fx((focus ? -1 : 1) * SPRITE_FOCUS_RAISE_PX);
 }
 
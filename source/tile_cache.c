@@ -0,0 +1,112 @@
+#include "tile_cache.h"
+#include "graphic_utils.h"
+#include "util.h"
+#include "vram_queue.h"
+
+#define TILE_CACHE_NO_KEY 0xFFFF
+
+typedef struct
+{
+    u16 key;
+    u16 refcount;
+    u32 last_release; // When the refcount last dropped to zero, for evicting the oldest first
+} TileCacheSlot;
+
+static TileCacheSlot slots[TILE_CACHE_NUM_SLOTS];
+static u32 release_clock = 0;
+static TileCacheStats stats = {0};
+
+void tile_cache_init(void)
+{
+    for (int i = 0; i < TILE_CACHE_NUM_SLOTS; i++)
+    {
+        slots[i].key = TILE_CACHE_NO_KEY;
+        slots[i].refcount = 0;
+        slots[i].last_release = 0;
+    }
+    release_clock = 0;
+}
+
+static inline TILE *tile_cache_slot_tiles(int slot)
+{
+    return &tile_mem[4][slot * TILE_CACHE_SLOT_TILES];
+}
+
+static int tile_cache_find(u16 key)
+{
+    for (int i = 0; i < TILE_CACHE_NUM_SLOTS; i++)
+    {
+        if (slots[i].key == key)
+            return i;
+    }
+    return UNDEFINED;
+}
+
+int tile_cache_acquire(u16 key, const u32 *tiles)
+{
+    int slot = tile_cache_find(key);
+    if (slot != UNDEFINED)
+    {
+        stats.hits++;
+        slots[slot].refcount++;
+        return slot * TILE_CACHE_SLOT_TILES;
+    }
+
+    // An empty slot if there is one, otherwise the unused slot released the longest ago
+    for (int i = 0; i < TILE_CACHE_NUM_SLOTS; i++)
+    {
+        if (slots[i].refcount > 0)
+            continue;
+
+        if (slots[i].key == TILE_CACHE_NO_KEY)
+        {
+            slot = i;
+            break;
+        }
+
+        if (slot == UNDEFINED || slots[i].last_release < slots[slot].last_release)
+        {
+            slot = i;
+        }
+    }
+
+    if (slot == UNDEFINED)
+        return UNDEFINED;
+
+    stats.misses++;
+    if (slots[slot].key != TILE_CACHE_NO_KEY)
+    {
+        stats.evictions++;
+    }
+
+    slots[slot].key = key;
+    slots[slot].refcount = 1;
+    vram_queue_copy32(tile_cache_slot_tiles(slot), tiles, TILE_SIZE * TILE_CACHE_SLOT_TILES);
+    return slot * TILE_CACHE_SLOT_TILES;
+}
+
+void tile_cache_release(int tile_index)
+{
+    int slot = tile_index / TILE_CACHE_SLOT_TILES;
+    if (tile_index < 0 || slot >= TILE_CACHE_NUM_SLOTS || slots[slot].refcount == 0)
+        return;
+
+    if (--slots[slot].refcount == 0)
+    {
+        slots[slot].last_release = ++release_clock;
+    }
+}
+
+void tile_cache_update(u16 key, const u32 *tiles)
+{
+    int slot = tile_cache_find(key);
+    if (slot == UNDEFINED)
+        return;
+
+    vram_queue_copy32(tile_cache_slot_tiles(slot), tiles, TILE_SIZE * TILE_CACHE_SLOT_TILES);
+}
+
+const TileCacheStats *tile_cache_get_stats(void)
+{
+    return &stats;
+}
@@ -0,0 +1,185 @@
+#include "vram_queue.h"
+
+// Smaller transfers are done by the CPU in less time than it takes to set up DMA3
+#define VRAM_QUEUE_DMA_MIN_BYTES 32
+
+typedef struct
+{
+    void *dst;
+    const void *src;
+    u32 count; // In units of the transfer size
+    u32 fill;  // Fills are DMAs from this fixed source
+    u32 mode;  // DMA_16 or DMA_32, DMA_SRC_FIXED for fills
+} VramQueueEntry;
+
+// Game code adds to queues[back], the flush swaps buffers and carries what's left into the new back one
+static VramQueueEntry queues[2][VRAM_QUEUE_MAX_ENTRIES];
+static int queue_lens[2] = {0, 0};
+static int back = 0;
+static VramQueueStats stats = {0};
+
+static inline uint vram_queue_entry_unit(const VramQueueEntry *entry)
+{
+    return (entry->mode & DMA_32) ? 4 : 2;
+}
+
+// Same as the DMA, a fixed source for fills. Video memory takes 16 and 32-bit writes only
+static void vram_queue_cpu_copy(void *dst, const void *src, uint count, u32 mode)
+{
+    int src_step = (mode & DMA_SRC_FIXED) ? 0 : 1;
+    if (mode & DMA_32)
+    {
+        u32 *dst32 = dst;
+        const u32 *src32 = src;
+        for (uint i = 0; i < count; i++, src32 += src_step)
+        {
+            dst32[i] = *src32;
+        }
+    }
+    else
+    {
+        u16 *dst16 = dst;
+        const u16 *src16 = src;
+        for (uint i = 0; i < count; i++, src16 += src_step)
+        {
+            dst16[i] = *src16;
+        }
+    }
+}
+
+static void vram_queue_transfer(VramQueueEntry *entry, uint count)
+{
+    bool is_fill = entry->mode & DMA_SRC_FIXED;
+    const void *src = is_fill ? &entry->fill : entry->src;
+    uint bytes = count * vram_queue_entry_unit(entry);
+
+    if (bytes < VRAM_QUEUE_DMA_MIN_BYTES)
+    {
+        vram_queue_cpu_copy(entry->dst, src, count, entry->mode);
+    }
+    else
+    {
+        dma_cpy(entry->dst, src, count, 3, DMA_NOW | entry->mode);
+    }
+
+    entry->dst = (u8 *)entry->dst + bytes;
+    if (!is_fill)
+    {
+        entry->src = (const u8 *)entry->src + bytes;
+    }
+    entry->count -= count;
+    stats.bytes_moved += bytes;
+}
+
+// Moves everything queued right away, to make room when the queue is full
+static void vram_queue_flush_all(void)
+{
+    VramQueueEntry *entries = queues[back];
+    for (int i = 0; i < queue_lens[back]; i++)
+    {
+        vram_queue_transfer(&entries[i], entries[i].count);
+    }
+    queue_lens[back] = 0;
+    stats.forced_flushes++;
+}
+
+static void vram_queue_push(void *dst, const void *src, uint count, u32 fill, u32 mode)
+{
+    if (count == 0)
+        return;
+
+    if (queue_lens[back] == VRAM_QUEUE_MAX_ENTRIES)
+    {
+        vram_queue_flush_all();
+    }
+
+    VramQueueEntry *entry = &queues[back][queue_lens[back]++];
+    entry->dst = dst;
+    entry->src = src;
+    entry->count = count;
+    entry->fill = fill;
+    entry->mode = mode;
+
+    stats.depth = queue_lens[back];
+    if (stats.depth > stats.max_depth)
+    {
+        stats.max_depth = stats.depth;
+    }
+}
+
+void vram_queue_copy16(void *dst, const void *src, uint hwcount)
+{
+    vram_queue_push(dst, src, hwcount, 0, DMA_16);
+}
+
+void vram_queue_copy32(void *dst, const void *src, uint wcount)
+{
+    vram_queue_push(dst, src, wcount, 0, DMA_32);
+}
+
+void vram_queue_fill16(void *dst, u16 hw, uint hwcount)
+{
+    vram_queue_push(dst, NULL, hwcount, hw, DMA_16 | DMA_SRC_FIXED);
+}
+
+void vram_queue_fill32(void *dst, u32 wd, uint wcount)
+{
+    vram_queue_push(dst, NULL, wcount, wd, DMA_32 | DMA_SRC_FIXED);
+}
+
+void vram_queue_flush(void)
+{
+    VramQueueEntry *entries = queues[back];
+    int num_entries = queue_lens[back];
+    back ^= 1;
+    queue_lens[back] = 0;
+
+    uint budget = VRAM_QUEUE_FRAME_BUDGET;
+    int i;
+    for (i = 0; i < num_entries; i++)
+    {
+        VramQueueEntry *entry = &entries[i];
+        uint unit = vram_queue_entry_unit(entry);
+        if (entry->count * unit <= budget)
+        {
+            budget -= entry->count * unit;
+            vram_queue_transfer(entry, entry->count);
+            continue;
+        }
+
+        // Move what fits of the entry, the rest goes first next frame
+        uint count = budget / unit;
+        if (count > 0)
+        {
+            budget -= count * unit;
+            vram_queue_transfer(entry, count);
+        }
+        break;
+    }
+
+    if (i < num_entries)
+    {
+        stats.overflows++;
+    }
+
+    for (; i < num_entries; i++)
+    {
+        queues[back][queue_lens[back]++] = entries[i];
+    }
+
+    stats.depth = queue_lens[back];
+    stats.last_flush_bytes = VRAM_QUEUE_FRAME_BUDGET - budget;
+}
+
+void vram_queue_flush_now(void)
+{
+    if (queue_lens[back] > 0)
+    {
+        vram_queue_flush_all();
+    }
+}
+
+const VramQueueStats *vram_queue_get_stats(void)
+{
+    return &stats;
+}